@@ -101,4 +101,190 @@ void main() async {
               e.code == FidlErrorCode.fidlStrictXUnionUnknownField)));
     });
   });
+
+  group('encoder buffers', () {
+    // Empties the pool, which holds at most 8 buffers.
+    void drainPool() {
+      for (int i = 0; i < 8; i++) {
+        Encoder(1);
+      }
+    }
+
+    test('are reused once released', () async {
+      drainPool();
+      final encoder = Encoder()..alloc(8);
+      encoder.encodeInt64(-1, 0);
+      final message = encoder.message..release();
+
+      final reused = Encoder(8)..alloc(8);
+      expect(identical(reused.data.buffer, message.data.buffer), isTrue);
+      // Encoding relies on fresh memory being zero.
+      expect(reused.data.getInt64(0, Endian.little), equals(0));
+    });
+
+    test('are presized from the hint', () async {
+      final encoder = Encoder(4096);
+      expect(encoder.data.lengthInBytes, greaterThanOrEqualTo(4096));
+      final buffer = encoder.data.buffer;
+      encoder.alloc(4096);
+      expect(identical(encoder.data.buffer, buffer), isTrue);
+    });
+
+    test('are taken smallest first', () async {
+      drainPool();
+      final large = (Encoder(32768)..alloc(8)).message;
+      final small = (Encoder(20000)..alloc(8)).message;
+      large.release();
+      small.release();
+
+      final encoder = Encoder(16384);
+      expect(identical(encoder.data.buffer, small.data.buffer), isTrue);
+    });
+  });
+
+  group('generated codecs', () {
+    Message encode<T>(FidlType<T> type, T value) {
+      final encoder = Encoder()..alloc(type.inlineSize);
+      type.encode(encoder, value, 0);
+      return encoder.message;
+    }
+
+    Uint8List bytesOf(Message message) =>
+        message.data.buffer.asUint8List(0, message.data.lengthInBytes);
+
+    test('match the generic struct codec', () async {
+      final generic = StructType<ExampleStruct>(
+          inlineSize: kExampleStruct_Type.inlineSize,
+          members: kExampleStruct_Type.members,
+          ctor: kExampleStruct_Type.ctor);
+      final value =
+          ExampleStruct(foo: 'hello', bar: 42, baz: Uint8List.fromList([1, 2]));
+      final message = encode(kExampleStruct_Type, value);
+      expect(bytesOf(message), equals(bytesOf(encode(generic, value))));
+
+      final decoder = Decoder(message)
+        ..claimMemory(kExampleStruct_Type.inlineSize);
+      expect(kExampleStruct_Type.decode(decoder, 0), equals(value));
+    });
+
+    test('match the generic table codec', () async {
+      final generic = TableType<ExampleTable>(
+          inlineSize: kExampleTable_Type.inlineSize,
+          members: kExampleTable_Type.members,
+          ctor: kExampleTable_Type.ctor);
+      // Leaves a gap before the last field present.
+      final value = ExampleTable(foo: 'hello', baz: Uint8List.fromList([1]));
+      final message = encode(kExampleTable_Type, value);
+      expect(bytesOf(message), equals(bytesOf(encode(generic, value))));
+
+      final decoder = Decoder(message)
+        ..claimMemory(kExampleTable_Type.inlineSize);
+      expect(kExampleTable_Type.decode(decoder, 0), equals(value));
+    });
+  });
+
+  group('primitive vectors', () {
+    const vectorType = VectorType<List<int>>(
+        element: Uint64Type(), maybeElementCount: null, nullable: false);
+    final value = [1, -2, 0x0102030405060708];
+
+    // Decodes [value] from a ByteData that starts [start] bytes into its
+    // buffer, as a message read into a larger buffer does.
+    List<int> decodeAt(int start) {
+      final encoder = Encoder()..alloc(vectorType.inlineSize);
+      vectorType.encode(encoder, value, 0);
+      final message = encoder.message;
+      final length = message.data.lengthInBytes;
+      final bytes = Uint8List(start + length)
+        ..setRange(start, start + length,
+            message.data.buffer.asUint8List(0, length));
+      final decoder =
+          Decoder.fromRawArgs(bytes.buffer.asByteData(start, length), [])
+            ..claimMemory(vectorType.inlineSize);
+      final List<int> decoded = vectorType.decode(decoder, 0);
+      expect(decoded, equals(value));
+      return decoded;
+    }
+
+    test('are views of aligned data at an offset', () async {
+      final decoded = decodeAt(8) as Uint64List;
+      // The elements follow the 16 byte vector header.
+      expect(decoded.offsetInBytes, equals(8 + 16));
+    });
+
+    test('are copied from unaligned data', () async {
+      final decoded = decodeAt(4) as Uint64List;
+      expect(decoded.offsetInBytes, equals(0));
+      expect(decoded.lengthInBytes, equals(decoded.buffer.lengthInBytes));
+    });
+  });
+
+  group('struct vectors', () {
+    final generic = StructType<Int64Struct>(
+        inlineSize: kInt64Struct_Type.inlineSize,
+        members: kInt64Struct_Type.members,
+        ctor: kInt64Struct_Type.ctor);
+    final value = [Int64Struct(x: 1), Int64Struct(x: -2)];
+
+    VectorType<List<Int64Struct>> vectorOf(StructType<Int64Struct> element) =>
+        VectorType<List<Int64Struct>>(
+            element: element, maybeElementCount: null, nullable: false);
+
+    Message encode(StructType<Int64Struct> element) {
+      final vectorType = vectorOf(element);
+      final encoder = Encoder()..alloc(vectorType.inlineSize);
+      vectorType.encode(encoder, value, 0);
+      return encoder.message;
+    }
+
+    List<Int64Struct> decode(StructType<Int64Struct> element, Message message) {
+      final vectorType = vectorOf(element);
+      final decoder = Decoder(message)..claimMemory(vectorType.inlineSize);
+      return vectorType.decode(decoder, 0);
+    }
+
+    Uint8List bytesOf(Message message) =>
+        message.data.buffer.asUint8List(0, message.data.lengthInBytes);
+
+    test('match the generic struct codec', () async {
+      final message = encode(kInt64Struct_Type);
+      expect(bytesOf(message), equals(bytesOf(encode(generic))));
+      expect(decode(kInt64Struct_Type, message), equals(value));
+      expect(decode(generic, message), equals(value));
+    });
+  });
+
+  group('lazy tables', () {
+    setUpAll(() => enableLazyDecoding(kExampleTable_Type));
+
+    Message encode(ExampleTable value) {
+      final encoder = Encoder()..alloc(kExampleTable_Type.inlineSize);
+      kExampleTable_Type.encode(encoder, value, 0);
+      return encoder.message;
+    }
+
+    ExampleTable decode(Message message) {
+      final decoder = Decoder(message)
+        ..claimMemory(kExampleTable_Type.inlineSize);
+      return kExampleTable_Type.decode(decoder, 0);
+    }
+
+    test('decode fields on first read', () async {
+      final value = ExampleTable(foo: 'hello', baz: Uint8List.fromList([1]));
+      final decoded = decode(encode(value));
+      expect(decoded.runtimeType, equals(ExampleTable));
+      expect(decoded.foo, equals('hello'));
+      expect(decoded.bar, isNull);
+      expect(decoded, equals(value));
+    });
+
+    test('fail safely on malformed fields', () async {
+      final message = encode(ExampleTable(foo: 'hello'));
+      // Overwrite the size of the string, which follows the header and the
+      // envelope.
+      message.data.setUint64(32, 100, Endian.little);
+      final decoded = decode(message);
+      expect(() => decoded.foo, throwsA(predicate((e) => e is FidlError)));
+    });
+  });
 }
@@ -4,6 +4,7 @@
 
 import 'dart:async';
 
+import 'package:fidl/fidl.dart';
 import 'package:fidl_fidl_examples_bindingstest/fidl_async.dart';
 import 'package:test/test.dart';
 
@@ -55,6 +56,14 @@ void main() async {
       return server.controller.kill();
     });
 
+    test('synchronous call times out', () {
+      server.proxy.ctrl
+        ..synchronousCalls = true
+        ..callTimeout = Duration(milliseconds: 10);
+      expect(server.proxy.replySlowly('whoa dude', 1.0),
+          throwsA(predicate((e) => e is FidlError)));
+    });
+
     test('one-way call on closed proxy', () {
       server.proxy.ctrl.close();
       expect(server.proxy.oneWayNoArgs(), throwsA(anything));
@@ -8,6 +8,7 @@ import (
 	"fmt"
 	"log"
 	"regexp"
+	"sort"
 	"strconv"
 	"strings"
 
@@ -29,6 +30,9 @@ type Type struct {
 	declType      types.DeclType
 	typedDataDecl string
 	typeExpr      string
+	// The Encoder and Decoder methods for a primitive type are named after
+	// it, such as encodeUint8. Empty for other types.
+	codecSuffix string
 }
 
 // Const represents a constant declaration.
@@ -94,10 +98,19 @@ type XUnionMember struct {
 	Documented
 }
 
+// MemberType is a constant for the type of a struct or table member, shared
+// by the generated encoder and decoder and the declaration's type.
+type MemberType struct {
+	Decl   string
+	Symbol string
+	Expr   string
+}
+
 // Struct represents a struct declaration.
 type Struct struct {
 	Name             string
 	Members          []StructMember
+	MemberTypes      []MemberType
 	TypeSymbol       string
 	TypeExpr         string
 	HasNullableField bool
@@ -111,15 +124,25 @@ type StructMember struct {
 	DefaultValue string
 	OffsetV1     int
 	typeExpr     string
+	// EncodeExpr encodes the member of $value at $offset and DecodeExpr
+	// decodes it.
+	EncodeExpr string
+	DecodeExpr string
 	Documented
 }
 
 // Table represents a table declaration.
 type Table struct {
-	Name       string
-	Members    []TableMember
-	TypeSymbol string
-	TypeExpr   string
+	Name        string
+	Members     []TableMember
+	MemberTypes []MemberType
+	TypeSymbol  string
+	TypeExpr    string
+	// The statements that encode and decode the envelopes up to the last
+	// known ordinal, including the reserved ones, and the ordinal after it.
+	EncodeEnvelopes []string
+	DecodeEnvelopes []string
+	UnknownOrdinal  int
 	Documented
 }
 
@@ -129,7 +152,7 @@ type TableMember struct {
 	Type         Type
 	Name         string
 	DefaultValue string
-	typeExpr     string
+	TypeSymbol   string
 	Documented
 }
 
@@ -397,6 +420,10 @@ func formatParameterList(params []StructMember) string {
 	return fmt.Sprintf("<$fidl.MemberType>[\n%s    ]", strings.Join(lines, ""))
 }
 
+func formatMemberType(decl string, typeExpr string, offset int) string {
+	return fmt.Sprintf("$fidl.MemberType<%s>(type: %s, offset: %v)", decl, typeExpr, offset)
+}
+
 func formatStructMemberList(members []StructMember) string {
 	if len(members) == 0 {
 		return "<$fidl.MemberType>[]"
@@ -419,7 +446,7 @@ func formatTableMemberList(members []TableMember) string {
 	lines := []string{}
 
 	for _, v := range members {
-		lines = append(lines, fmt.Sprintf("    %d: %s,\n", v.Ordinal, v.Type.typeExpr))
+		lines = append(lines, fmt.Sprintf("    %d: %s,\n", v.Ordinal, v.TypeSymbol))
 	}
 
 	return fmt.Sprintf("<int, $fidl.FidlType>{\n%s  }", strings.Join(lines, ""))
@@ -473,18 +500,43 @@ func (c *compiler) getPayload(name types.EncodedCompoundIdentifier) types.Struct
 	return val
 }
 
+const (
+	// The size of the transactional message header.
+	messageHeaderSize = 16
+	// ZX_CHANNEL_MAX_MSG_BYTES, the most bytes a message can hold.
+	channelMaxMessageBytes = 65536
+	// The size an Encoder starts with when it is given no hint.
+	defaultMessageSizeHint = 1024
+)
+
+// messageSizeHint returns the most bytes a message with the given payload
+// can encode to, which its encoder is presized for. Payloads that are
+// unbounded, or bounded only by what a channel can carry, say nothing about
+// the size of a typical message, so they get the default size instead.
+func messageSizeHint(payload types.Struct) int {
+	size := messageHeaderSize + payload.TypeShapeV1.InlineSize + payload.TypeShapeV1.MaxOutOfLine
+	if size > channelMaxMessageBytes {
+		return defaultMessageSizeHint
+	}
+	return size
+}
+
 func (c *compiler) typeExprForMethod(val types.Method, request []StructMember, response []StructMember, name string) string {
 	var (
-		requestSize  = 0
-		responseSize = 0
+		requestSize      = 0
+		responseSize     = 0
+		requestSizeHint  = messageHeaderSize
+		responseSizeHint = messageHeaderSize
 	)
 	if val.RequestPayload != "" {
 		payload := c.getPayload(val.RequestPayload)
 		requestSize = payload.TypeShapeV1.InlineSize
+		requestSizeHint = messageSizeHint(payload)
 	}
 	if val.ResponsePayload != "" {
 		payload := c.getPayload(val.ResponsePayload)
 		responseSize = payload.TypeShapeV1.InlineSize
+		responseSizeHint = messageSizeHint(payload)
 	}
 
 	// request/response and requestInlineSize/responseInlineSize are null/0 for both empty
@@ -496,8 +548,10 @@ func (c *compiler) typeExprForMethod(val types.Method, request []StructMember, r
 		name: r"%s",
 		requestInlineSize: %d,
 		responseInlineSize: %d,
+		requestSizeHint: %d,
+		responseSizeHint: %d,
 	  )`, formatParameterList(request), formatParameterList(response), name,
-		requestSize, responseSize)
+		requestSize, responseSize, requestSizeHint, responseSizeHint)
 }
 
 func (c *compiler) inExternalLibrary(ci types.CompoundIdentifier) bool {
@@ -709,6 +763,7 @@ func (c *compiler) compileType(val types.Type) Type {
 		r.AsyncDecl = r.Decl
 		r.typedDataDecl = typedDataDecl[val.PrimitiveSubtype]
 		r.typeExpr = typeExprForPrimitiveSubtype(val.PrimitiveSubtype)
+		r.codecSuffix = strings.TrimSuffix(typeForPrimitiveSubtype[val.PrimitiveSubtype], "Type")
 	case types.IdentifierType:
 		compound := types.ParseCompoundIdentifier(val.Identifier)
 		t := c.compileUpperCamelCompoundIdentifier(compound, "", declarationContext)
@@ -1004,15 +1059,13 @@ func (c *compiler) compileStructMember(val types.StructMember) StructMember {
 		defaultValue = c.compileConstant(*val.MaybeDefaultValue, &t)
 	}
 
-	typeStr := fmt.Sprintf("type: %s", t.typeExpr)
-	offsetStr := fmt.Sprintf("offset: %v", val.FieldShapeV1.Offset)
 	return StructMember{
-		t,
-		c.compileLowerCamelIdentifier(val.Name, structMemberContext),
-		defaultValue,
-		val.FieldShapeV1.Offset,
-		fmt.Sprintf("$fidl.MemberType<%s>(%s, %s)", t.Decl, typeStr, offsetStr),
-		docString(val),
+		Type:         t,
+		Name:         c.compileLowerCamelIdentifier(val.Name, structMemberContext),
+		DefaultValue: defaultValue,
+		OffsetV1:     val.FieldShapeV1.Offset,
+		typeExpr:     formatMemberType(t.Decl, t.typeExpr, val.FieldShapeV1.Offset),
+		Documented:   docString(val),
 	}
 }
 
@@ -1045,11 +1098,30 @@ func (c *compiler) compileStruct(val types.Struct) Struct {
 
 	r.HasNullableField = hasNullableField
 
+	for i := range r.Members {
+		m := &r.Members[i]
+		offset := "$offset"
+		if m.OffsetV1 != 0 {
+			offset = fmt.Sprintf("$offset + %d", m.OffsetV1)
+		}
+		if suffix := m.Type.codecSuffix; suffix != "" {
+			m.EncodeExpr = fmt.Sprintf("$encoder.encode%s($value.%s, %s)", suffix, m.Name, offset)
+			m.DecodeExpr = fmt.Sprintf("$decoder.decode%s(%s)", suffix, offset)
+		} else {
+			typeExpr := hoistMemberType(&r.MemberTypes, r.Name, m.Name, m.Type)
+			m.EncodeExpr = fmt.Sprintf("%s.encode($encoder, $value.%s, %s)", typeExpr, m.Name, offset)
+			m.DecodeExpr = fmt.Sprintf("%s.decode($decoder, %s)", typeExpr, offset)
+			m.typeExpr = formatMemberType(m.Type.Decl, typeExpr, m.OffsetV1)
+		}
+	}
+
 	r.TypeExpr = fmt.Sprintf(`$fidl.StructType<%s>(
   inlineSize: %v,
   members: %s,
   ctor: %s._ctor,
-)`, r.Name, val.TypeShapeV1.InlineSize, formatStructMemberList(r.Members), r.Name)
+  encodeFn: %s._encode,
+  decodeFn: %s._decode,
+)`, r.Name, val.TypeShapeV1.InlineSize, formatStructMemberList(r.Members), r.Name, r.Name, r.Name)
 	return r
 }
 
@@ -1082,14 +1154,63 @@ func (c *compiler) compileTable(val types.Table) Table {
 		r.Members = append(r.Members, c.compileTableMember(v))
 	}
 
+	// The envelopes below are laid out in ordinal order, so do not rely on the
+	// order the members are listed in.
+	sort.Slice(r.Members, func(i, j int) bool {
+		return r.Members[i].Ordinal < r.Members[j].Ordinal
+	})
+
+	// Reserved ordinals still have envelopes, which are encoded absent and
+	// skipped when decoding.
+	r.UnknownOrdinal = 1
+	for i := range r.Members {
+		m := &r.Members[i]
+		m.TypeSymbol = hoistMemberType(&r.MemberTypes, r.Name, m.Name, m.Type)
+		for ; r.UnknownOrdinal < m.Ordinal; r.UnknownOrdinal++ {
+			r.EncodeEnvelopes = append(r.EncodeEnvelopes, fmt.Sprintf(
+				"$fidl.encodeTableEnvelope($encoder, $envelopes, %d, $maxOrdinal, null, null);", r.UnknownOrdinal))
+			r.DecodeEnvelopes = append(r.DecodeEnvelopes, fmt.Sprintf(
+				"$fidl.decodeTableEnvelope($decoder, $envelopes, %d, $maxOrdinal, null);", r.UnknownOrdinal))
+		}
+		r.EncodeEnvelopes = append(r.EncodeEnvelopes, fmt.Sprintf(
+			"$fidl.encodeTableEnvelope($encoder, $envelopes, %d, $maxOrdinal, $value.%s, %s);",
+			m.Ordinal, m.Name, m.TypeSymbol))
+		r.DecodeEnvelopes = append(r.DecodeEnvelopes, fmt.Sprintf(
+			"final %s %s = $fidl.decodeTableEnvelope($decoder, $envelopes, %d, $maxOrdinal, %s);",
+			m.Type.Decl, m.Name, m.Ordinal, m.TypeSymbol))
+		r.UnknownOrdinal++
+	}
+
+	lazyCtor := ""
+	if len(r.Members) != 0 {
+		lazyCtor = fmt.Sprintf("\n  lazyCtor: %s._lazyCtor,", r.Name)
+	}
 	r.TypeExpr = fmt.Sprintf(`$fidl.TableType<%s>(
   inlineSize: %v,
   members: %s,
   ctor: %s._ctor,
-)`, r.Name, val.TypeShapeV1.InlineSize, formatTableMemberList(r.Members), r.Name)
+  encodeFn: %s._encode,
+  decodeFn: %s._decode,%s
+)`, r.Name, val.TypeShapeV1.InlineSize, formatTableMemberList(r.Members), r.Name, r.Name, r.Name, lazyCtor)
 	return r
 }
 
+// hoistMemberType returns the name for the type of a member. Types that are
+// constructed rather than declared are hoisted into constants so that the
+// generated encoder and decoder do not build them on every call.
+func hoistMemberType(memberTypes *[]MemberType, owner string, member string, t Type) string {
+	if !strings.HasPrefix(t.typeExpr, "$fidl.") {
+		return t.typeExpr
+	}
+	symbol := fmt.Sprintf("_k%s_%s_Type", owner, member)
+	*memberTypes = append(*memberTypes, MemberType{
+		Decl:   t.typeExpr[:strings.Index(t.typeExpr, "(")],
+		Symbol: symbol,
+		Expr:   t.typeExpr,
+	})
+	return symbol
+}
+
 func (c *compiler) compileXUnion(val types.XUnion) XUnion {
 	var members []XUnionMember
 	for _, member := range val.Members {
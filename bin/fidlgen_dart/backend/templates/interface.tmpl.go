@@ -297,7 +297,7 @@ class {{ .ProxyName }} extends $fidl.AsyncProxy<{{ .Name }}>
         return $async.Future.error($fidl.FidlStateException('Proxy<${ctrl.$interfaceName}> is closed.'), StackTrace.current);
       }
 
-      final $fidl.Encoder $encoder = $fidl.Encoder();
+      final $fidl.Encoder $encoder = $fidl.Encoder({{ .TypeSymbol }}.requestSizeHint);
       $encoder.encodeMessageHeader({{ .Ordinals.Write.Name }}, 0);
       {{- if .Request }}
         $encoder.alloc({{ .TypeSymbol }}.encodingRequestInlineSize($encoder));
@@ -343,7 +343,7 @@ class {{ .BindingName }} extends $fidl.AsyncBinding<{{ .Name }}> {
         {{- if not .HasRequest }}
           if (impl.{{ .Name }} != null) {
             $subscriptions.add(impl.{{ .Name }}.listen(($response) {
-              final $fidl.Encoder $encoder = $fidl.Encoder();
+              final $fidl.Encoder $encoder = $fidl.Encoder({{ .TypeSymbol }}.responseSizeHint);
               $encoder.encodeMessageHeader({{ .Ordinals.Write.Name }}, 0);
               $encoder.alloc({{ .TypeSymbol }}.encodingResponseInlineSize($encoder));
               final List<$fidl.MemberType> $types = {{ .TypeSymbol }}.response;
@@ -408,7 +408,7 @@ class {{ .BindingName }} extends $fidl.AsyncBinding<{{ .Name }}> {
                 })
                 {{ end }}
                 .then(($response) {
-                  final $fidl.Encoder $encoder = $fidl.Encoder();
+                  final $fidl.Encoder $encoder = $fidl.Encoder({{ .TypeSymbol }}.responseSizeHint);
                   $encoder.encodeMessageHeader({{ .Ordinals.Write.Name }}, $message.txid);
                   {{- if .Response.WireParameters }}
                     $encoder.alloc({{ .TypeSymbol }}.encodingResponseInlineSize($encoder));
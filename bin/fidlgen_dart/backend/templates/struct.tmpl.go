@@ -79,10 +79,28 @@ class {{ .Name }} extends $fidl.Struct {
   }
 
   static {{ .Name }} _ctor(List<Object> argv) => {{ .Name }}._(argv);
+
+  static void _encode($fidl.Encoder $encoder, {{ .Name }} $value, int $offset) {
+{{- range .Members }}
+    {{ .EncodeExpr }};
+{{- end }}
+  }
+
+  static {{ .Name }} _decode($fidl.Decoder $decoder, int $offset) {
+    return {{ .Name }}(
+{{- range .Members }}
+      {{ .Name }}: {{ .DecodeExpr }},
+{{- end }}
+    );
+  }
 }
 
 // See FIDL-308:
 // ignore: recursive_compile_time_constant
 const $fidl.StructType<{{ .Name }}> {{ .TypeSymbol }} = {{ .TypeExpr }};
+{{- range .MemberTypes }}
+// ignore: recursive_compile_time_constant
+const {{ .Decl }} {{ .Symbol }} = {{ .Expr }};
+{{- end }}
 {{ end }}
 `
@@ -42,10 +42,67 @@ class {{ .Name }} extends $fidl.Table {
   }
 
   static {{ .Name }} _ctor(Map<int, dynamic> argv) => {{ .Name }}._(argv);
+
+  static void _encode($fidl.Encoder $encoder, {{ .Name }} $value, int $offset) {
+{{- if len .Members }}
+    int $maxOrdinal = 0;
+{{- range .Members }}
+    if ($value.{{ .Name }} != null) {
+      $maxOrdinal = {{ .Ordinal }};
+    }
+{{- end }}
+    final int $envelopes = $fidl.encodeTableHeader($encoder, $maxOrdinal, $offset);
+{{- range .EncodeEnvelopes }}
+    {{ . }}
+{{- end }}
+{{- else }}
+    $fidl.encodeTableHeader($encoder, 0, $offset);
+{{- end }}
+  }
+
+  static {{ .Name }} _decode($fidl.Decoder $decoder, int $offset) {
+    final int $maxOrdinal = $fidl.decodeTableHeader($decoder, $offset);
+    final int $envelopes = $fidl.claimTableEnvelopes($decoder, $maxOrdinal);
+{{- range .DecodeEnvelopes }}
+    {{ . }}
+{{- end }}
+    $fidl.skipTableEnvelopes($decoder, $envelopes, {{ .UnknownOrdinal }}, $maxOrdinal);
+    return {{ .Name }}(
+{{- range .Members }}
+      {{ .Name }}: {{ .Name }},
+{{- end }}
+    );
+  }
+{{- if len .Members }}
+
+  static {{ .Name }} _lazyCtor($fidl.LazyTableFields $fields) =>
+      _{{ .Name }}Lazy($fields);
+{{- end }}
 }
+{{- if len .Members }}
+
+// The lazily decoded form of {{ .Name }}, see $fidl.enableLazyDecoding.
+class _{{ .Name }}Lazy extends {{ .Name }} {
+  _{{ .Name }}Lazy(this._fields);
+
+  final $fidl.LazyTableFields _fields;
+
+  @override
+  Type get runtimeType => {{ .Name }};
+{{- range .Members }}
+
+  @override
+  {{ .Type.Decl }} get {{ .Name }} => _fields.field({{ .Ordinal }}, {{ .TypeSymbol }});
+{{- end }}
+}
+{{- end }}
 
 // See FIDL-308:
 // ignore: recursive_compile_time_constant
 const $fidl.TableType<{{ .Name }}> {{ .TypeSymbol }} = {{ .TypeExpr }};
+{{- range .MemberTypes }}
+// ignore: recursive_compile_time_constant
+const {{ .Decl }} {{ .Symbol }} = {{ .Expr }};
+{{- end }}
 {{ end }}
 `
@@ -120,13 +120,14 @@ void Initialize(fidl::InterfaceHandle<fuchsia::sys::Environment> environment,
 
   result = Dart_SetField(
       library, ToDart("_environment"),
-      ToDart(zircon::dart::Handle::Create(environment.TakeChannel())));
+      ToDart(zircon::dart::Handle::Create(
+          environment.TakeChannel().release())));
   FXL_CHECK(!tonic::LogIfError(result));
 
   if (directory_request) {
     result = Dart_SetField(
         library, ToDart("_outgoingServices"),
-        ToDart(zircon::dart::Handle::Create(std::move(directory_request))));
+        ToDart(zircon::dart::Handle::Create(directory_request.release())));
     FXL_CHECK(!tonic::LogIfError(result));
   }
 }
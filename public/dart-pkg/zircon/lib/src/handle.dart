@@ -37,7 +37,27 @@ class Handle extends NativeFieldWrapperClass2 {
   HandleWaiter asyncWait(int signals, AsyncWaitCallback callback)
       native 'Handle_AsyncWait';
 
+  /// Like [asyncWait], but [callback] is called again every time one of
+  /// [signals] is observed after it returns, until the waiter is cancelled,
+  /// the wait fails, or peer-closed is the only signal left.
+  ///
+  /// [callback] runs in the zone this is called from, and an error it throws
+  /// is reported to that zone without ending the wait.
+  HandleWaiter asyncWaitPersistent(int signals, AsyncWaitCallback callback) =>
+      _asyncWaitPersistent(
+          signals, Zone.current.bindBinaryCallbackGuarded(callback));
+  HandleWaiter _asyncWaitPersistent(int signals, AsyncWaitCallback callback)
+      native 'Handle_AsyncWaitPersistent';
+
   Handle duplicate(int rights) native 'Handle_Duplicate';
+
+  /// Returns a handle to the same object with [rights], cancelling any
+  /// pending waits. This handle is invalid afterwards, even on failure, in
+  /// which case the returned handle is invalid too.
+  Handle replace(int rights) native 'Handle_Replace';
+
+  static List<Object> _takeWaitCompletions()
+      native 'Handle_TakeWaitCompletions';
 }
 
 @pragma('vm:entry-point')
@@ -53,3 +73,27 @@ class _OnWaitCompleteClosure {  // ignore: unused_element
   @pragma('vm:entry-point')
   Function get _closure => () => _callback(_arg1, _arg2); // ignore: unused_element
 }
+
+// Runs the wait completions queued natively since the last drain. Native
+// code schedules this as one microtask whenever the queue becomes non-empty,
+// instead of one closure and microtask per completion.
+@pragma('vm:entry-point')
+void _drainWaitCompletions() { // ignore: unused_element
+  _runWaitCompletions(Handle._takeWaitCompletions(), 0);
+}
+
+void _runWaitCompletions(List<Object> completions, int start) {
+  for (int i = start; i < completions.length; i += 3) {
+    try {
+      final Function callback = completions[i];
+      callback(completions[i + 1], completions[i + 2]);
+    } catch (_) {
+      // Leave the rest to another microtask, as if each completion had its
+      // own.
+      if (i + 3 < completions.length) {
+        scheduleMicrotask(() => _runWaitCompletions(completions, i + 3));
+      }
+      rethrow;
+    }
+  }
+}
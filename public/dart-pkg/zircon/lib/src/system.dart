@@ -76,6 +76,37 @@ class ReadResult extends _Result {
       'ReadResult(status=$status, bytes=$bytes, numBytes=$numBytes, handles=$handles)';
 }
 
+@pragma('vm:entry-point')
+class ReadBatchResult extends _Result {
+  final ByteData bytes;
+  final Uint32List byteOffsets;
+  final Uint32List handleOffsets;
+  final List<Handle> handles;
+  @pragma('vm:entry-point')
+  const ReadBatchResult(final int status,
+      [this.bytes, this.byteOffsets, this.handleOffsets, this.handles])
+      : super(status);
+
+  /// The number of messages packed into [bytes].
+  int get numMessages => byteOffsets == null ? 0 : byteOffsets.length - 1;
+
+  /// Returns the [index]th message of the batch as a [ReadResult] whose bytes
+  /// are a view into [bytes].
+  ReadResult messageAt(int index) {
+    final int start = byteOffsets[index];
+    final int numBytes = byteOffsets[index + 1] - start;
+    return ReadResult(
+        status,
+        bytes.buffer.asByteData(bytes.offsetInBytes + start, numBytes),
+        numBytes,
+        handles.sublist(handleOffsets[index], handleOffsets[index + 1]));
+  }
+
+  @override
+  String toString() =>
+      'ReadBatchResult(status=$status, numMessages=$numMessages, handles=$handles)';
+}
+
 @pragma('vm:entry-point')
 class WriteResult extends _Result {
   final int numBytes;
@@ -109,10 +140,12 @@ class FromFileResult extends _Result {
 @pragma('vm:entry-point')
 class MapResult extends _Result {
   final Uint8List data;
+  final Handle region;
   @pragma('vm:entry-point')
-  const MapResult(final int status, [this.data]) : super(status);
+  const MapResult(final int status, [this.data, this.region])
+      : super(status);
   @override
-  String toString() => 'MapResult(status=$status, data=$data)';
+  String toString() => 'MapResult(status=$status, data=$data, region=$region)';
 }
 
 @pragma('vm:entry-point')
@@ -127,10 +160,22 @@ class System extends NativeFieldWrapperClass2 {
       native 'System_ChannelFromFile';
   static int connectToService(String path, Handle channel)
       native 'System_ConnectToService';
+  static int connectToServices(List<String> paths, List<Handle> channels)
+      native 'System_ConnectToServices';
   static int channelWrite(Handle channel, ByteData data, List<Handle> handles)
       native 'System_ChannelWrite';
+  static int channelWriteV(
+      Handle channel, List<TypedData> segments, List<Handle> handles)
+      native 'System_ChannelWriteV';
+  static ReadResult channelRead(Handle channel) native 'System_ChannelRead';
   static ReadResult channelQueryAndRead(Handle channel)
       native 'System_ChannelQueryAndRead';
+  static ReadBatchResult channelReadBatch(
+      Handle channel, int maxMessages, int maxBytes)
+      native 'System_ChannelReadBatch';
+  static ReadResult channelCall(
+      Handle channel, ByteData data, List<Handle> handles, int deadline)
+      native 'System_ChannelCall';
 
   // Eventpair operations.
   static HandlePairResult eventpairCreate([int options = 0])
@@ -143,6 +188,9 @@ class System extends NativeFieldWrapperClass2 {
       native 'System_SocketWrite';
   static ReadResult socketRead(Handle socket, int size)
       native 'System_SocketRead';
+  static int socketReadInto(
+      Handle socket, ByteData target, int targetOffset, int size)
+      native 'System_SocketReadInto';
 
   // Vmo operations.
   static HandleResult vmoCreate(int size, [int options = 0])
@@ -154,8 +202,90 @@ class System extends NativeFieldWrapperClass2 {
       native 'System_VmoWrite';
   static ReadResult vmoRead(Handle vmo, int offset, int size)
       native 'System_VmoRead';
+  static int vmoReadInto(
+      Handle vmo, int offset, ByteData target, int targetOffset, int size)
+      native 'System_VmoReadInto';
   static MapResult vmoMap(Handle vmo) native 'System_VmoMap';
+  static MapResult vmoMapRange(Handle vmo, int offset, int length, int flags)
+      native 'System_VmoMapRange';
+  static MapResult vmoMapRegion(Handle vmo, int offset, int length, int flags)
+      native 'System_VmoMapRegion';
+  static int vmoUnmap(Handle region) native 'System_VmoUnmap';
+  static MapResult mapFile(String path, int offset, int length, bool exact)
+      native 'System_MapFile';
+
+  // Handle operations.
+  /// Closes all valid [handles] with a single syscall, cancelling their
+  /// pending waits.
+  static int handleCloseMany(List<Handle> handles)
+      native 'System_HandleCloseMany';
 
   // Time operations.
   static int clockGet(int clockId) native 'System_ClockGet';
+
+  // Allocation-free variants. These return the status and leave any other
+  // result in per-isolate slots, which stay valid until the next such call.
+  static final Uint64List _outValues = _getOutValues();
+  static Uint64List _getOutValues() native 'System_GetOutValues';
+
+  /// Bytes transferred by the last [socketWriteRaw], [socketReadInto] or
+  /// [channelReadInto].
+  static int get lastNumBytes => _outValues[0];
+
+  /// Handles received by the last [channelReadInto].
+  static int get lastNumHandles => _outValues[1];
+
+  /// Size returned by the last [vmoGetSizeRaw].
+  static int get lastSize => _outValues[2];
+
+  static int socketWriteRaw(Handle socket, ByteData data, int options)
+      native 'System_SocketWriteRaw';
+  static int vmoGetSizeRaw(Handle vmo) native 'System_VmoGetSizeRaw';
+
+  /// Reads the next message into [target] and its handles into the first
+  /// [lastNumHandles] entries of [handles], which must be a fixed-length list
+  /// or null. If either is too small the read fails with
+  /// ZX.ERR_BUFFER_TOO_SMALL, the message stays queued and [lastNumBytes] and
+  /// [lastNumHandles] are the sizes it needs.
+  static int channelReadInto(
+      Handle channel, ByteData target, List<Handle> handles)
+      native 'System_ChannelReadInto';
+
+  /// The number of Dart objects that natives have allocated for their
+  /// results in this isolate: result objects, byte buffers, lists and the
+  /// [Handle]s in them.
+  static int get nativeAllocations => _getNativeAllocations();
+  static int _getNativeAllocations() native 'System_GetNativeAllocations';
+
+  // Instrumentation.
+  /// Turns counting of native calls on or off for this isolate.
+  static void setNativeStatsEnabled(bool enabled)
+      native 'System_SetNativeStatsEnabled';
+
+  /// The native call counters of this isolate. The list is a live view: it
+  /// reflects later calls without being fetched again.
+  static Uint64List getNativeStats() native 'System_GetNativeStats';
+
+  /// The names of the natives counted in [getNativeStats], in order.
+  static List<String> getNativeStatsNames()
+      native 'System_GetNativeStatsNames';
+
+  // Tracing.
+  /// Writes trace events to the file at [path] in the Chrome trace event
+  /// format, or stops tracing if [path] is empty. Events are buffered, and the
+  /// previous file is complete once this returns.
+  static int setTraceFile(String path) native 'System_SetTraceFile';
+
+  /// Events traced with [traceEnd]. Decoding by a binding includes the
+  /// synchronous part of dispatching the message.
+  static const int TRACE_FIDL_ENCODE = 0;
+  static const int TRACE_FIDL_DECODE = 1;
+
+  /// Returns the start of a traced span, or 0 if tracing is off.
+  static int traceBegin() native 'System_TraceBegin';
+
+  /// Ends the span of [event] for the message with [ordinal] that started
+  /// at [start], as returned by [traceBegin].
+  static void traceEnd(int event, int start, int ordinal)
+      native 'System_TraceEnd';
 }
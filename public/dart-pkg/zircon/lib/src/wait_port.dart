@@ -0,0 +1,50 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of zircon;
+
+// ignore_for_file: native_function_body_in_non_sdk_code
+// ignore_for_file: public_member_api_docs
+
+/// Receives a batch of completed waits. Entry `i` of the batch is stored at
+/// `completions[3 * i]` (the key), `completions[3 * i + 1]` (the status) and
+/// `completions[3 * i + 2]` (the observed signals).
+///
+/// An entry whose key is [WaitPort.allWaits] reports that the port failed
+/// with its status: every wait still pending has ended, and no more
+/// completions will be delivered.
+typedef WaitPortCallback = void Function(Uint64List completions, int count);
+
+/// Waits on many handles, delivering all the waits that completed since the
+/// last delivery in one callback.
+///
+/// A WaitPort that is no longer referenced is closed when it is collected.
+@pragma('vm:entry-point')
+class WaitPort extends NativeFieldWrapperClass2 {
+  // Private constructor.
+  @pragma('vm:entry-point')
+  WaitPort._();
+
+  /// The key of the completion that ends every pending wait.
+  static const int allWaits = 1 << 32;
+
+  factory WaitPort(WaitPortCallback callback) =>
+      _create().._callback = callback;
+  static WaitPort _create() native 'WaitPort_Create';
+
+  // Read by the native code on each delivery. Holding the callback here
+  // rather than natively lets an unreferenced port be collected.
+  @pragma('vm:entry-point')
+  WaitPortCallback _callback;
+
+  /// Starts a one-shot wait for [signals] on [handle]. [key] must fit in 32
+  /// bits and identifies the wait in the completions.
+  int wait(Handle handle, int signals, int key) native 'WaitPort_Wait';
+
+  /// Cancels the wait on [handle] with [key].
+  int cancel(Handle handle, int key) native 'WaitPort_Cancel';
+
+  /// Drops all waits. The callback will not be called again.
+  void close() native 'WaitPort_Close';
+}
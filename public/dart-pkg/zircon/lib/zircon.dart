@@ -4,6 +4,7 @@
 
 library zircon;
 
+import 'dart:async' show Zone, scheduleMicrotask;
 import 'dart:convert' show utf8;
 import 'dart:nativewrappers';
 import 'dart:typed_data';
@@ -11,3 +12,4 @@ import 'dart:typed_data';
 part 'src/handle.dart';
 part 'src/handle_waiter.dart';
 part 'src/system.dart';
+part 'src/wait_port.dart';
@@ -6,6 +6,9 @@
 
 #include <algorithm>
 
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+#include "dart-pkg/zircon/sdk_ext/native_stats.h"
+#include "dart-pkg/zircon/sdk_ext/trace_sink.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_class_library.h"
 
@@ -16,33 +19,33 @@ namespace dart {
 
 IMPLEMENT_WRAPPERTYPEINFO(zircon, Handle);
 
-Handle::Handle(zx_handle_t handle) : handle_(handle) {
-  tonic::DartState* state = tonic::DartState::Current();
-  FXL_DCHECK(state);
-  Dart_Handle zircon_lib = Dart_LookupLibrary(ToDart("dart:zircon"));
-  FXL_DCHECK(!tonic::LogIfError(zircon_lib));
-
-  Dart_Handle on_wait_completer_type = Dart_GetClass(
-      zircon_lib, ToDart("_OnWaitCompleteClosure"));
-  FXL_DCHECK(!tonic::LogIfError(on_wait_completer_type));
-  on_wait_completer_type_.Set(state, on_wait_completer_type);
+namespace {
 
-  Dart_Handle async_lib = Dart_LookupLibrary(ToDart("dart:async"));
-  FXL_DCHECK(!tonic::LogIfError(async_lib));
-  async_lib_.Set(state, async_lib);
+void RecordWait(IsolateState* isolate_state,
+                zx_status_t status,
+                zx_ticks_t wait_started) {
+  NativeStats& stats = isolate_state->native_stats();
+  std::shared_ptr<TraceSink> sink = GetTraceSink();
+  if (!stats.enabled() && !sink) {
+    return;
+  }
+  zx_ticks_t now = zx_ticks_get();
+  if (stats.enabled()) {
+    stats.Record(NativeStats::kHandleWait, status, 0, 0, now - wait_started);
+  }
+  if (sink) {
+    sink->Duration("Handle.wait", wait_started, now, 0);
+  }
+}
 
-  Dart_Handle closure_string = ToDart("_closure");
-  FXL_DCHECK(!tonic::LogIfError(closure_string));
-  closure_string_.Set(state, closure_string);
+}  // namespace
 
-  Dart_Handle schedule_microtask_string = ToDart("scheduleMicrotask");
-  FXL_DCHECK(!tonic::LogIfError(schedule_microtask_string));
-  schedule_microtask_string_.Set(state, schedule_microtask_string);
-}
+Handle::Handle(zx_handle_t handle) : handle_(handle) {}
 
 Handle::~Handle() {
+  // Not Close(): the isolate may be gone, and with it the isolate's stats.
   if (is_valid()) {
-    zx_status_t status = Close();
+    zx_status_t status = zx_handle_close(ReleaseHandle());
     FXL_DCHECK(status == ZX_OK);
   }
 }
@@ -58,12 +61,15 @@ Dart_Handle Handle::CreateInvalid() {
 zx_handle_t Handle::ReleaseHandle() {
   FXL_DCHECK(is_valid());
 
+  // The handle is about to be closed, sent away or replaced, so the numbering
+  // of its one-way messages starts again if it shows up here later.
+  ForgetTraceSequences(handle_);
   zx_handle_t handle = handle_;
   handle_ = ZX_HANDLE_INVALID;
   while (waiters_.size()) {
     // HandleWaiter::Cancel calls Handle::ReleaseWaiter which removes the
-    // HandleWaiter from waiters_.
-    FXL_DCHECK(waiters_.back()->is_pending());
+    // HandleWaiter from waiters_. A persistent waiter whose callback is
+    // being delivered is registered but not pending.
     waiters_.back()->Cancel();
   }
 
@@ -73,11 +79,15 @@ zx_handle_t Handle::ReleaseHandle() {
 }
 
 zx_status_t Handle::Close() {
+  NativeCall stats(NativeStats::kHandleClose);
+  zx_status_t status = ZX_ERR_BAD_HANDLE;
   if (is_valid()) {
     zx_handle_t handle = ReleaseHandle();
-    return zx_handle_close(handle);
+    status = zx_handle_close(handle);
+    stats.add_handles(1);
   }
-  return ZX_ERR_BAD_HANDLE;
+  stats.set_status(status);
+  return status;
 }
 
 fxl::RefPtr<HandleWaiter> Handle::AsyncWait(zx_signals_t signals,
@@ -94,6 +104,20 @@ fxl::RefPtr<HandleWaiter> Handle::AsyncWait(zx_signals_t signals,
   return waiter;
 }
 
+fxl::RefPtr<HandleWaiter> Handle::AsyncWaitPersistent(zx_signals_t signals,
+                                                      Dart_Handle callback) {
+  if (!is_valid()) {
+    FXL_LOG(WARNING) << "Attempt to wait on an invalid handle.";
+    return nullptr;
+  }
+
+  fxl::RefPtr<HandleWaiter> waiter =
+      HandleWaiter::Create(this, signals, callback, true);
+  waiters_.push_back(waiter.get());
+
+  return waiter;
+}
+
 void Handle::ReleaseWaiter(HandleWaiter* waiter) {
   FXL_DCHECK(waiter);
   auto iter = std::find(waiters_.cbegin(), waiters_.cend(), waiter);
@@ -102,13 +126,34 @@ void Handle::ReleaseWaiter(HandleWaiter* waiter) {
   waiters_.erase(iter);
 }
 
+Dart_Handle Handle::Replace(uint32_t rights) {
+  NativeCall stats(NativeStats::kHandleReplace);
+  if (!is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ToDart(Create(ZX_HANDLE_INVALID));
+  }
+
+  // Pending waits are cancelled while the old handle value is still valid.
+  // The old handle is consumed even if the replace fails.
+  zx_handle_t out_handle;
+  zx_status_t status = zx_handle_replace(ReleaseHandle(), rights, &out_handle);
+  stats.set_status(status);
+  if (status != ZX_OK) {
+    return ToDart(Create(ZX_HANDLE_INVALID));
+  }
+  return ToDart(Create(out_handle));
+}
+
 Dart_Handle Handle::Duplicate(uint32_t rights) {
+  NativeCall stats(NativeStats::kHandleDuplicate);
   if (!is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ToDart(Create(ZX_HANDLE_INVALID));
   }
 
   zx_handle_t out_handle;
   zx_status_t status = zx_handle_duplicate(handle_, rights, &out_handle);
+  stats.set_status(status);
   if (status != ZX_OK) {
     return ToDart(Create(ZX_HANDLE_INVALID));
   }
@@ -117,42 +162,52 @@ Dart_Handle Handle::Duplicate(uint32_t rights) {
 
 void Handle::ScheduleCallback(tonic::DartPersistentValue callback,
                               zx_status_t status,
-                              const zx_packet_signal_t* signal) {
+                              const zx_packet_signal_t* signal,
+                              zx_ticks_t wait_started) {
+  TraceDuration trace("Handle.scheduleCallback");
   auto state = callback.dart_state().lock();
   FXL_DCHECK(state);
   tonic::DartState::Scope scope(state);
 
-  // Make a new _OnWaitCompleteClosure(callback, status, signal->observed).
   FXL_DCHECK(!callback.is_empty());
-  std::vector<Dart_Handle> constructor_args{
-      callback.Release(), ToDart(status), ToDart(signal->observed)};
-  Dart_Handle on_wait_complete_closure = Dart_New(on_wait_completer_type_.Get(),
-      Dart_Null(), constructor_args.size(), constructor_args.data());
-  FXL_DCHECK(!tonic::LogIfError(on_wait_complete_closure));
-
-  // The _callback field contains the thunk:
-  // () => callback(status, signal->observed)
-  Dart_Handle closure = Dart_GetField(on_wait_complete_closure,
-      closure_string_.Get());
-  FXL_DCHECK(!tonic::LogIfError(closure));
-
-  // Put the thunk on the microtask queue by calling scheduleMicrotask().
-  std::vector<Dart_Handle> sm_args{closure};
-  Dart_Handle sm_result = Dart_Invoke(async_lib_.Get(),
-      schedule_microtask_string_.Get(), sm_args.size(), sm_args.data());
-  FXL_DCHECK(!tonic::LogIfError(sm_result));
+  IsolateState* isolate_state = IsolateState::Current();
+  RecordWait(isolate_state, status, wait_started);
+  isolate_state->AddWaitCompletion(std::move(callback), nullptr, status,
+                                   signal->observed);
 }
 
-// clang-format: off
+void Handle::SchedulePersistentCallback(HandleWaiter* waiter,
+                                        zx_status_t status,
+                                        const zx_packet_signal_t* signal) {
+  TraceDuration trace("Handle.scheduleCallback");
+  auto state = waiter->dart_state().lock();
+  FXL_DCHECK(state);
+  tonic::DartState::Scope scope(state);
 
-#define FOR_EACH_STATIC_BINDING(V) V(Handle, CreateInvalid)
+  IsolateState* isolate_state = IsolateState::Current();
+  RecordWait(isolate_state, status, waiter->wait_started());
+  isolate_state->AddWaitCompletion(tonic::DartPersistentValue(),
+                                   fxl::RefPtr<HandleWaiter>(waiter), status,
+                                   signal->observed);
+}
+
+Dart_Handle Handle::TakeWaitCompletions() {
+  return IsolateState::Current()->TakeWaitCompletions();
+}
+
+// clang-format: off
 
-#define FOR_EACH_BINDING(V) \
-  V(Handle, handle)         \
-  V(Handle, is_valid)       \
-  V(Handle, Close)          \
-  V(Handle, AsyncWait)      \
-  V(Handle, Duplicate)
+#define FOR_EACH_STATIC_BINDING(V) \
+  V(Handle, CreateInvalid)         \
+  V(Handle, TakeWaitCompletions)
+
+// handle and is_valid are bound as leaf natives; see leaf_natives.h.
+#define FOR_EACH_BINDING(V)      \
+  V(Handle, Close)               \
+  V(Handle, AsyncWait)           \
+  V(Handle, AsyncWaitPersistent) \
+  V(Handle, Duplicate)           \
+  V(Handle, Replace)
 
 // clang-format: on
 
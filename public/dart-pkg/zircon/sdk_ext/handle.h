@@ -34,9 +34,6 @@ class Handle : public fxl::RefCountedThreadSafe<Handle>,
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
   static fxl::RefPtr<Handle> Create(zx_handle_t handle);
-  static fxl::RefPtr<Handle> Create(zx::handle handle) {
-    return Create(handle.release());
-  }
 
   static fxl::RefPtr<Handle> Unwrap(Dart_Handle handle) {
     return fxl::RefPtr<Handle>(
@@ -56,13 +53,30 @@ class Handle : public fxl::RefCountedThreadSafe<Handle>,
   fxl::RefPtr<HandleWaiter> AsyncWait(zx_signals_t signals,
                                       Dart_Handle callback);
 
+  fxl::RefPtr<HandleWaiter> AsyncWaitPersistent(zx_signals_t signals,
+                                                Dart_Handle callback);
+
   void ReleaseWaiter(HandleWaiter* waiter);
 
   Dart_Handle Duplicate(uint32_t rights);
 
+  // Replaces the handle with one that has |rights|, invalidating this one.
+  Dart_Handle Replace(uint32_t rights);
+
+  // Schedules a call of |callback|. |wait_started| is when the wait was
+  // armed, for the isolate's NativeStats.
   void ScheduleCallback(tonic::DartPersistentValue callback,
                         zx_status_t status,
-                        const zx_packet_signal_t* signal);
+                        const zx_packet_signal_t* signal,
+                        zx_ticks_t wait_started);
+
+  // Schedules a call of |waiter|'s callback, leaving |waiter| registered.
+  void SchedulePersistentCallback(HandleWaiter* waiter,
+                                  zx_status_t status,
+                                  const zx_packet_signal_t* signal);
+
+  // Returns the wait completions queued since the last call.
+  static Dart_Handle TakeWaitCompletions();
 
  private:
   explicit Handle(zx_handle_t handle);
@@ -74,13 +88,6 @@ class Handle : public fxl::RefCountedThreadSafe<Handle>,
   zx_handle_t handle_;
 
   std::vector<HandleWaiter*> waiters_;
-
-  // Some cached persistent handles to make running handle wait completers
-  // faster.
-  tonic::DartPersistentValue async_lib_;
-  tonic::DartPersistentValue closure_string_;
-  tonic::DartPersistentValue on_wait_completer_type_;
-  tonic::DartPersistentValue schedule_microtask_string_;
 };
 
 }  // namespace dart
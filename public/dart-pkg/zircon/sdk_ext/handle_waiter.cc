@@ -5,6 +5,7 @@
 #include "dart-pkg/zircon/sdk_ext/handle_waiter.h"
 
 #include <lib/async/default.h>
+#include <zircon/syscalls.h>
 
 #include "dart-pkg/zircon/sdk_ext/handle.h"
 #include "src/lib/fxl/logging.h"
@@ -36,18 +37,23 @@ void HandleWaiter::RegisterNatives(tonic::DartLibraryNatives* natives) {
 
 fxl::RefPtr<HandleWaiter> HandleWaiter::Create(Handle* handle,
                                                zx_signals_t signals,
-                                               Dart_Handle callback) {
-  return fxl::MakeRefCounted<HandleWaiter>(handle, signals, callback);
+                                               Dart_Handle callback,
+                                               bool persistent) {
+  return fxl::MakeRefCounted<HandleWaiter>(handle, signals, callback,
+                                           persistent);
 }
 
 HandleWaiter::HandleWaiter(Handle* handle, zx_signals_t signals,
-                           Dart_Handle callback)
+                           Dart_Handle callback, bool persistent)
     : wait_(this, handle->handle(), signals),
+      rearm_task_(this),
       handle_(handle),
-      callback_(DartState::Current(), callback) {
+      callback_(DartState::Current(), callback),
+      persistent_(persistent) {
   FXL_CHECK(handle_ != nullptr);
   FXL_CHECK(handle_->is_valid());
 
+  wait_started_ = zx_ticks_get();
   zx_status_t status = wait_.Begin(async_get_default_dispatcher());
   FXL_DCHECK(status == ZX_OK);
 }
@@ -55,10 +61,16 @@ HandleWaiter::HandleWaiter(Handle* handle, zx_signals_t signals,
 HandleWaiter::~HandleWaiter() { Cancel(); }
 
 void HandleWaiter::Cancel() {
-  FXL_DCHECK(wait_.is_pending() == !!handle_);
+  // A persistent waiter is not pending while its completion is delivered.
+  FXL_DCHECK(persistent_ || wait_.is_pending() == !!handle_);
+  if (rearm_task_.is_pending()) {
+    rearm_task_.Cancel();
+  }
   if (handle_) {
     // Cancel the wait.
-    wait_.Cancel();
+    if (wait_.is_pending()) {
+      wait_.Cancel();
+    }
 
     // Release this object from the handle and clear handle_.
     handle_->ReleaseWaiter(this);
@@ -67,6 +79,17 @@ void HandleWaiter::Cancel() {
   FXL_DCHECK(!wait_.is_pending());
 }
 
+void HandleWaiter::Rearm(async_dispatcher_t* dispatcher, async::TaskBase* task,
+                         zx_status_t status) {
+  if (status != ZX_OK || !handle_ || wait_.is_pending()) {
+    // The loop is shutting down, or the handle was closed by the callback.
+    return;
+  }
+  wait_started_ = zx_ticks_get();
+  status = wait_.Begin(dispatcher);
+  FXL_DCHECK(status == ZX_OK);
+}
+
 void HandleWaiter::OnWaitComplete(async_dispatcher_t* dispatcher,
                                   async::WaitBase* wait, zx_status_t status,
                                   const zx_packet_signal_t* signal) {
@@ -77,11 +100,27 @@ void HandleWaiter::OnWaitComplete(async_dispatcher_t* dispatcher,
   // Hold a reference to this object.
   fxl::RefPtr<HandleWaiter> ref(this);
 
+  // Keep a persistent waiter registered while there is more than peer-closed
+  // to report. Channels, sockets and eventpairs share the peer-closed bit.
+  zx_signals_t others = signal->observed & wait_.trigger() &
+                        ~static_cast<zx_signals_t>(ZX_CHANNEL_PEER_CLOSED);
+  if (persistent_ && status == ZX_OK && others != 0) {
+    handle_->SchedulePersistentCallback(this, status, signal);
+    // The signals are level triggered, so waiting again now would complete
+    // at once for the message the callback has yet to read. The loop runs
+    // microtasks after each handler, so a task posted here re-arms the wait
+    // once the callback has run, without a call back in from Dart.
+    zx_status_t post_status = rearm_task_.Post(dispatcher);
+    FXL_DCHECK(post_status == ZX_OK);
+    return;
+  }
+
   // Remove this waiter from the handle.
   handle_->ReleaseWaiter(this);
 
   // Schedule the callback on the microtask queue.
-  handle_->ScheduleCallback(std::move(callback_), status, signal);
+  handle_->ScheduleCallback(std::move(callback_), status, signal,
+                            wait_started_);
 
   // Clear handle_.
   handle_ = nullptr;
@@ -5,10 +5,12 @@
 #ifndef DART_PKG_ZIRCON_SDK_EXT_HANDLE_WAITER_H_
 #define DART_PKG_ZIRCON_SDK_EXT_HANDLE_WAITER_H_
 
+#include <lib/async/cpp/task.h>
 #include <lib/async/cpp/wait.h>
-#include <lib/zx/handle.h>
+#include <zircon/types.h>
 
 #include "src/lib/fxl/memory/ref_counted.h"
+#include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/dart_wrappable.h"
 
 namespace tonic {
@@ -27,30 +29,50 @@ class HandleWaiter : public fxl::RefCountedThreadSafe<HandleWaiter>,
   FRIEND_MAKE_REF_COUNTED(HandleWaiter);
 
  public:
+  // A persistent waiter keeps its callback after a completion and re-arms
+  // natively once the callback has run. It stops when the wait fails, when the
+  // only signal observed is peer-closed, or when it is cancelled.
   static fxl::RefPtr<HandleWaiter> Create(Handle* handle, zx_signals_t signals,
-                                          Dart_Handle callback);
+                                          Dart_Handle callback,
+                                          bool persistent = false);
 
   void Cancel();
 
   bool is_pending() { return wait_.is_pending(); }
 
+  Dart_Handle callback() { return callback_.Get(); }
+
+  // When the wait was last armed.
+  zx_ticks_t wait_started() const { return wait_started_; }
+
+  const std::weak_ptr<tonic::DartState>& dart_state() {
+    return callback_.dart_state();
+  }
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   explicit HandleWaiter(Handle* handle, zx_signals_t signals,
-                        Dart_Handle callback);
+                        Dart_Handle callback, bool persistent);
   ~HandleWaiter();
 
   void OnWaitComplete(async_dispatcher_t* dispatcher, async::WaitBase* wait,
                       zx_status_t status, const zx_packet_signal_t* signal);
 
+  // Starts waiting again after a persistent completion has been delivered.
+  void Rearm(async_dispatcher_t* dispatcher, async::TaskBase* task,
+             zx_status_t status);
+
   void RetainDartWrappableReference() const override { AddRef(); }
 
   void ReleaseDartWrappableReference() const override { Release(); }
 
   async::WaitMethod<HandleWaiter, &HandleWaiter::OnWaitComplete> wait_;
+  async::TaskMethod<HandleWaiter, &HandleWaiter::Rearm> rearm_task_;
   Handle* handle_;
   tonic::DartPersistentValue callback_;
+  const bool persistent_;
+  zx_ticks_t wait_started_ = 0;
 };
 
 }  // namespace dart
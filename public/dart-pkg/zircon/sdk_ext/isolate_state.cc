@@ -0,0 +1,216 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+
+#include <zircon/types.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "src/lib/fxl/logging.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/dart_class_library.h"
+#include "third_party/tonic/logging/dart_error.h"
+
+namespace zircon {
+namespace dart {
+namespace {
+
+std::mutex g_states_mutex;
+
+// All live states, keyed by their isolate's DartState. Entries whose
+// DartState has gone away are purged whenever a new state is created.
+std::unordered_map<tonic::DartState*, std::unique_ptr<IsolateState>>*
+    g_states;
+
+// The state of the isolate that last used dart:zircon on this thread. The
+// weak pointer guards against the DartState being destroyed and its address
+// being reused by a later isolate.
+thread_local std::weak_ptr<tonic::DartState> t_dart_state;
+thread_local IsolateState* t_state = nullptr;
+
+}  // namespace
+
+IsolateState::IsolateState(std::weak_ptr<tonic::DartState> dart_state)
+    : dart_state_(std::move(dart_state)) {}
+
+IsolateState::~IsolateState() = default;
+
+void IsolateState::Create() {
+  tonic::DartState* dart_state = tonic::DartState::Current();
+  FXL_DCHECK(dart_state);
+
+  std::lock_guard<std::mutex> lock(g_states_mutex);
+  if (!g_states) {
+    g_states = new std::unordered_map<tonic::DartState*,
+                                      std::unique_ptr<IsolateState>>();
+  }
+  for (auto it = g_states->begin(); it != g_states->end();) {
+    if (it->second->dart_state_.expired()) {
+      it = g_states->erase(it);
+    } else {
+      ++it;
+    }
+  }
+  std::unique_ptr<IsolateState>& state = (*g_states)[dart_state];
+  if (!state) {
+    state.reset(new IsolateState(dart_state->GetWeakPtr()));
+  }
+}
+
+IsolateState* IsolateState::Current() {
+  tonic::DartState* dart_state = tonic::DartState::Current();
+  FXL_DCHECK(dart_state);
+  if (t_state && t_dart_state.lock().get() == dart_state) {
+    return t_state;
+  }
+
+  std::lock_guard<std::mutex> lock(g_states_mutex);
+  FXL_DCHECK(g_states);
+  auto it = g_states->find(dart_state);
+  FXL_CHECK(it != g_states->end() && !it->second->dart_state_.expired())
+      << "dart:zircon used by an isolate that was not initialized";
+  t_dart_state = it->second->dart_state_;
+  t_state = it->second.get();
+  return t_state;
+}
+
+uint8_t* IsolateState::message_buffer(size_t size) {
+  if (message_buffer_size_ < size) {
+    message_buffer_.reset(new uint8_t[size]);
+    message_buffer_size_ = size;
+  }
+  return message_buffer_.get();
+}
+
+Dart_Handle IsolateState::GetClass(const char* class_name) {
+  // The class library owns the persistent handle for the isolate's lifetime;
+  // this only skips its string building and lookup.
+  Dart_PersistentHandle& type = classes_[class_name];
+  if (!type) {
+    type = tonic::DartState::Current()->class_library().GetClass("zircon",
+                                                                 class_name);
+  }
+  Dart_Handle result = Dart_HandleFromPersistent(type);
+  FXL_DCHECK(!tonic::LogIfError(result));
+  return result;
+}
+
+void IsolateState::InitWaitCompletion() {
+  if (!on_wait_completer_type_.is_empty()) {
+    return;
+  }
+
+  tonic::DartState* state = tonic::DartState::Current();
+  Dart_Handle zircon_lib = Dart_LookupLibrary(tonic::ToDart("dart:zircon"));
+  FXL_DCHECK(!tonic::LogIfError(zircon_lib));
+
+  Dart_Handle on_wait_completer_type =
+      Dart_GetClass(zircon_lib, tonic::ToDart("_OnWaitCompleteClosure"));
+  FXL_DCHECK(!tonic::LogIfError(on_wait_completer_type));
+  on_wait_completer_type_.Set(state, on_wait_completer_type);
+
+  Dart_Handle drain_wait_completions =
+      Dart_GetField(zircon_lib, tonic::ToDart("_drainWaitCompletions"));
+  FXL_DCHECK(!tonic::LogIfError(drain_wait_completions));
+  drain_wait_completions_.Set(state, drain_wait_completions);
+
+  Dart_Handle async_lib = Dart_LookupLibrary(tonic::ToDart("dart:async"));
+  FXL_DCHECK(!tonic::LogIfError(async_lib));
+  async_lib_.Set(state, async_lib);
+
+  Dart_Handle closure_string = tonic::ToDart("_closure");
+  FXL_DCHECK(!tonic::LogIfError(closure_string));
+  closure_string_.Set(state, closure_string);
+
+  Dart_Handle schedule_microtask_string = tonic::ToDart("scheduleMicrotask");
+  FXL_DCHECK(!tonic::LogIfError(schedule_microtask_string));
+  schedule_microtask_string_.Set(state, schedule_microtask_string);
+}
+
+Dart_Handle IsolateState::async_lib() {
+  InitWaitCompletion();
+  return async_lib_.Get();
+}
+
+Dart_Handle IsolateState::closure_string() {
+  InitWaitCompletion();
+  return closure_string_.Get();
+}
+
+Dart_Handle IsolateState::on_wait_completer_type() {
+  InitWaitCompletion();
+  return on_wait_completer_type_.Get();
+}
+
+Dart_Handle IsolateState::drain_wait_completions() {
+  InitWaitCompletion();
+  return drain_wait_completions_.Get();
+}
+
+Dart_Handle IsolateState::schedule_microtask_string() {
+  InitWaitCompletion();
+  return schedule_microtask_string_.Get();
+}
+
+void IsolateState::ScheduleWaitCallback(Dart_Handle callback,
+                                        Dart_Handle arg1,
+                                        Dart_Handle arg2) {
+  // Make a new _OnWaitCompleteClosure(callback, arg1, arg2).
+  std::vector<Dart_Handle> constructor_args{callback, arg1, arg2};
+  Dart_Handle on_wait_complete_closure =
+      Dart_New(on_wait_completer_type(), Dart_Null(), constructor_args.size(),
+               constructor_args.data());
+  FXL_DCHECK(!tonic::LogIfError(on_wait_complete_closure));
+
+  // The _callback field contains the thunk: () => callback(arg1, arg2)
+  Dart_Handle closure =
+      Dart_GetField(on_wait_complete_closure, closure_string());
+  FXL_DCHECK(!tonic::LogIfError(closure));
+
+  ScheduleMicrotask(closure);
+}
+
+void IsolateState::AddWaitCompletion(tonic::DartPersistentValue callback,
+                                     fxl::RefPtr<HandleWaiter> waiter,
+                                     zx_status_t status,
+                                     zx_signals_t observed) {
+  FXL_DCHECK(callback.is_empty() != !waiter);
+  bool schedule_drain = wait_completions_.empty();
+  wait_completions_.push_back(
+      {std::move(callback), std::move(waiter), status, observed});
+  if (schedule_drain) {
+    ScheduleMicrotask(drain_wait_completions());
+  }
+}
+
+Dart_Handle IsolateState::TakeWaitCompletions() {
+  std::vector<WaitCompletion> completions;
+  completions.swap(wait_completions_);
+
+  Dart_Handle list = Dart_NewList(completions.size() * 3);
+  FXL_DCHECK(!tonic::LogIfError(list));
+  intptr_t index = 0;
+  for (WaitCompletion& completion : completions) {
+    Dart_Handle callback = completion.waiter ? completion.waiter->callback()
+                                             : completion.callback.Release();
+    Dart_ListSetAt(list, index++, callback);
+    Dart_ListSetAt(list, index++, tonic::ToDart(completion.status));
+    Dart_ListSetAt(list, index++, tonic::ToDart(completion.observed));
+  }
+  return list;
+}
+
+void IsolateState::ScheduleMicrotask(Dart_Handle closure) {
+  // Put the closure on the microtask queue by calling scheduleMicrotask().
+  std::vector<Dart_Handle> sm_args{closure};
+  Dart_Handle sm_result = Dart_Invoke(async_lib(), schedule_microtask_string(),
+                                      sm_args.size(), sm_args.data());
+  FXL_DCHECK(!tonic::LogIfError(sm_result));
+}
+
+}  // namespace dart
+}  // namespace zircon
@@ -0,0 +1,132 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DART_PKG_ZIRCON_SDK_EXT_ISOLATE_STATE_H_
+#define DART_PKG_ZIRCON_SDK_EXT_ISOLATE_STATE_H_
+
+#include <lib/fdio/namespace.h>
+#include <zircon/types.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "dart-pkg/zircon/sdk_ext/handle_waiter.h"
+#include "dart-pkg/zircon/sdk_ext/native_stats.h"
+#include "src/lib/fxl/macros.h"
+#include "third_party/dart/runtime/include/dart_api.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/dart_state.h"
+
+namespace zircon {
+namespace dart {
+
+/**
+ * IsolateState holds the native state that dart:zircon keeps for each
+ * isolate. It is created by Initialize() and lives as long as the isolate's
+ * tonic::DartState.
+ */
+class IsolateState {
+ public:
+  ~IsolateState();
+
+  // Creates the state for the current isolate.
+  static void Create();
+
+  // Returns the state of the current isolate.
+  static IsolateState* Current();
+
+  // A scratch buffer of at least |size| bytes, large enough for any channel
+  // message by default. It is kept at the largest size asked for, and is only
+  // valid for the duration of a single native call.
+  uint8_t* message_buffer(size_t size = ZX_CHANNEL_MAX_MSG_BYTES);
+
+  // Returns the dart:zircon class named |class_name|. Classes are cached by
+  // the address of |class_name|, so callers must pass a string constant.
+  Dart_Handle GetClass(const char* class_name);
+
+  // Output slots for natives that return a bare status. They are exposed to
+  // Dart as a Uint64List so that extra results can be read back without
+  // allocating a result object. Each kind of result has its own slot.
+  enum OutValue {
+    kOutNumBytes,
+    kOutNumHandles,
+    kOutSize,
+    kNumOutValues,
+  };
+  uint64_t* out_values() { return out_values_; }
+
+  // The number of Dart objects that natives have allocated for their
+  // results: result objects, byte buffers, lists and the Handles in them.
+  uint64_t allocations() const { return allocations_; }
+  void CountAllocations(uint64_t count) { allocations_ += count; }
+
+  // Call counters of the isolate's natives.
+  NativeStats& native_stats() { return native_stats_; }
+
+  // The isolate's fdio namespace, once it has been looked up.
+  fdio_ns_t* fdio_namespace() const { return fdio_namespace_; }
+  void set_fdio_namespace(fdio_ns_t* ns) { fdio_namespace_ = ns; }
+
+  // Library and class handles used to deliver handle wait completions,
+  // shared by all Handle objects of the isolate.
+  Dart_Handle async_lib();
+  Dart_Handle closure_string();
+  Dart_Handle on_wait_completer_type();
+  Dart_Handle drain_wait_completions();
+  Dart_Handle schedule_microtask_string();
+
+  // Schedules a microtask that calls |callback| with |arg1| and |arg2|.
+  void ScheduleWaitCallback(Dart_Handle callback,
+                            Dart_Handle arg1,
+                            Dart_Handle arg2);
+
+  // Queues a call of |callback| with |status| and |observed|. A persistent
+  // |waiter| passes no callback; its own is called, and it re-arms itself. The queue is drained by a single microtask, which is
+  // scheduled when the first completion is added to an empty queue.
+  void AddWaitCompletion(tonic::DartPersistentValue callback,
+                         fxl::RefPtr<HandleWaiter> waiter,
+                         zx_status_t status,
+                         zx_signals_t observed);
+
+  // Hands the queued completions to Dart as a flat list of (callback,
+  // status, observed) entries and empties the queue.
+  Dart_Handle TakeWaitCompletions();
+
+ private:
+  explicit IsolateState(std::weak_ptr<tonic::DartState> dart_state);
+
+  std::weak_ptr<tonic::DartState> dart_state_;
+  std::unique_ptr<uint8_t[]> message_buffer_;
+  size_t message_buffer_size_ = 0;
+  std::unordered_map<const char*, Dart_PersistentHandle> classes_;
+  uint64_t out_values_[kNumOutValues] = {};
+  uint64_t allocations_ = 0;
+  fdio_ns_t* fdio_namespace_ = nullptr;
+  NativeStats native_stats_;
+
+  void InitWaitCompletion();
+  void ScheduleMicrotask(Dart_Handle closure);
+
+  tonic::DartPersistentValue async_lib_;
+  tonic::DartPersistentValue closure_string_;
+  tonic::DartPersistentValue on_wait_completer_type_;
+  tonic::DartPersistentValue drain_wait_completions_;
+  tonic::DartPersistentValue schedule_microtask_string_;
+
+  struct WaitCompletion {
+    tonic::DartPersistentValue callback;
+    fxl::RefPtr<HandleWaiter> waiter;
+    zx_status_t status;
+    zx_signals_t observed;
+  };
+  std::vector<WaitCompletion> wait_completions_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(IsolateState);
+};
+
+}  // namespace dart
+}  // namespace zircon
+
+#endif  // DART_PKG_ZIRCON_SDK_EXT_ISOLATE_STATE_H_
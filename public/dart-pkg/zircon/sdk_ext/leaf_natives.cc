@@ -0,0 +1,114 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dart-pkg/zircon/sdk_ext/leaf_natives.h"
+
+#include <string.h>
+#include <zircon/syscalls.h>
+
+#include "dart-pkg/zircon/sdk_ext/handle.h"
+#include "dart-pkg/zircon/sdk_ext/system.h"
+#include "src/lib/fxl/arraysize.h"
+#include "src/lib/fxl/logging.h"
+#include "third_party/tonic/dart_wrappable.h"
+
+namespace zircon {
+namespace dart {
+namespace {
+
+// None of the functions below may create a Dart handle: there is no API
+// scope to hold it. The Dart signatures guarantee the argument types, so
+// the accessors cannot fail for anything but a null argument, which reads
+// as a null Handle and is rejected for integers in debug builds.
+
+Handle* GetHandleArgument(Dart_NativeArguments args, int index) {
+  intptr_t native_fields[tonic::DartWrappable::kNumberOfNativeFields] = {};
+  Dart_Handle result = Dart_GetNativeFieldsOfArgument(
+      args, index, tonic::DartWrappable::kNumberOfNativeFields, native_fields);
+  FXL_DCHECK(!Dart_IsError(result));
+  return reinterpret_cast<Handle*>(
+      native_fields[tonic::DartWrappable::kPeerIndex]);
+}
+
+int64_t GetIntegerArgument(Dart_NativeArguments args, int index) {
+  int64_t value = 0;
+  Dart_Handle result = Dart_GetNativeIntegerArgument(args, index, &value);
+  FXL_DCHECK(!Dart_IsError(result));
+  return value;
+}
+
+void Handle_handle(Dart_NativeArguments args) {
+  Handle* handle = GetHandleArgument(args, 0);
+  Dart_SetIntegerReturnValue(args, handle ? handle->handle() : 0);
+}
+
+void Handle_is_valid(Dart_NativeArguments args) {
+  Handle* handle = GetHandleArgument(args, 0);
+  Dart_SetBooleanReturnValue(args, handle && handle->is_valid());
+}
+
+void System_ClockGet(Dart_NativeArguments args) {
+  uint32_t clock_id = static_cast<uint32_t>(GetIntegerArgument(args, 0));
+  Dart_SetIntegerReturnValue(args, System::ClockGet(clock_id));
+}
+
+void System_VmoGetSizeRaw(Dart_NativeArguments args) {
+  Handle* vmo = GetHandleArgument(args, 0);
+  Dart_SetIntegerReturnValue(args, System::VmoGetSizeRaw(vmo));
+}
+
+void System_GetNativeAllocations(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, System::GetNativeAllocations());
+}
+
+void System_TraceBegin(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, System::TraceBegin());
+}
+
+void System_TraceEnd(Dart_NativeArguments args) {
+  System::TraceEnd(static_cast<int>(GetIntegerArgument(args, 0)),
+                   GetIntegerArgument(args, 1), GetIntegerArgument(args, 2));
+}
+
+struct LeafNative {
+  const char* name;
+  Dart_NativeFunction function;
+  int argument_count;
+};
+
+// Argument counts include the receiver of instance methods.
+const LeafNative kLeafNatives[] = {
+    {"Handle_handle", Handle_handle, 1},
+    {"Handle_is_valid", Handle_is_valid, 1},
+    {"System_ClockGet", System_ClockGet, 1},
+    {"System_VmoGetSizeRaw", System_VmoGetSizeRaw, 1},
+    {"System_GetNativeAllocations", System_GetNativeAllocations, 0},
+    {"System_TraceBegin", System_TraceBegin, 0},
+    {"System_TraceEnd", System_TraceEnd, 3},
+};
+
+}  // namespace
+
+Dart_NativeFunction LookupLeafNative(const char* name, int argument_count) {
+  for (size_t i = 0; i < arraysize(kLeafNatives); i++) {
+    const LeafNative& native = kLeafNatives[i];
+    if (native.argument_count == argument_count &&
+        strcmp(native.name, name) == 0) {
+      return native.function;
+    }
+  }
+  return nullptr;
+}
+
+const uint8_t* LeafNativeSymbol(Dart_NativeFunction native_function) {
+  for (size_t i = 0; i < arraysize(kLeafNatives); i++) {
+    if (kLeafNatives[i].function == native_function) {
+      return reinterpret_cast<const uint8_t*>(kLeafNatives[i].name);
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace dart
+}  // namespace zircon
@@ -0,0 +1,30 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DART_PKG_ZIRCON_SDK_EXT_LEAF_NATIVES_H_
+#define DART_PKG_ZIRCON_SDK_EXT_LEAF_NATIVES_H_
+
+#include "third_party/dart/runtime/include/dart_api.h"
+
+namespace zircon {
+namespace dart {
+
+/**
+ * Leaf natives are the dart:zircon natives that only take integers and
+ * Handle objects and only return integers or booleans. They read their
+ * arguments straight from the Dart_NativeArguments and never create a Dart
+ * handle, so they are resolved without an API scope and skip tonic's
+ * argument conversion. Natives that allocate Dart objects stay on tonic.
+ */
+
+// Returns the leaf implementation of |name|, or null if there is none.
+Dart_NativeFunction LookupLeafNative(const char* name, int argument_count);
+
+// Returns the name of |native_function| if it is a leaf native, or null.
+const uint8_t* LeafNativeSymbol(Dart_NativeFunction native_function);
+
+}  // namespace dart
+}  // namespace zircon
+
+#endif  // DART_PKG_ZIRCON_SDK_EXT_LEAF_NATIVES_H_
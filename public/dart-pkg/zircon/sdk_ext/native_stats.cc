@@ -0,0 +1,88 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dart-pkg/zircon/sdk_ext/native_stats.h"
+
+#include <algorithm>
+
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+#include "src/lib/fxl/arraysize.h"
+#include "src/lib/fxl/logging.h"
+
+namespace zircon {
+namespace dart {
+namespace {
+
+// Names as published to Dart, in the order of NativeStats::Native.
+const char* const kNativeNames[] = {
+    "Channel.write",
+    "Channel.writeV",
+    "Channel.read",
+    "Channel.call",
+    "Channel.readBatch",
+    "Socket.write",
+    "Socket.read",
+    "Vmo.write",
+    "Vmo.read",
+    "Handle.close",
+    "Handle.closeMany",
+    "Handle.duplicate",
+    "Handle.replace",
+    "Handle.wait",
+};
+static_assert(arraysize(kNativeNames) == NativeStats::kNumNatives,
+              "A native is missing a name");
+
+size_t LatencyBucket(zx_ticks_t elapsed) {
+  static const zx_ticks_t ticks_per_us =
+      std::max<zx_ticks_t>(zx_ticks_per_second() / 1000000, 1);
+  uint64_t us = elapsed / ticks_per_us;
+  if (us == 0) {
+    return 0;
+  }
+  size_t bucket = 64 - __builtin_clzll(us);
+  return std::min(bucket, NativeStats::kNumLatencyBuckets - 1);
+}
+
+}  // namespace
+
+const char* NativeStats::Name(Native native) {
+  FXL_DCHECK(native < kNumNatives);
+  return kNativeNames[native];
+}
+
+void NativeStats::Record(Native native,
+                         zx_status_t status,
+                         uint64_t bytes,
+                         uint64_t handles,
+                         zx_ticks_t elapsed) {
+  uint64_t* values = values_ + native * kNumFields;
+  values[kCalls]++;
+  // Finding nothing to read or no room to write is not a failure.
+  if (status != ZX_OK && status != ZX_ERR_SHOULD_WAIT) {
+    values[kErrors]++;
+  }
+  values[kBytes] += bytes;
+  values[kHandles] += handles;
+  values[kLatencyBuckets + LatencyBucket(elapsed)]++;
+}
+
+NativeCall::NativeCall(NativeStats::Native native)
+    : stats_(&IsolateState::Current()->native_stats()), native_(native) {
+  if (stats_->enabled()) {
+    start_ = zx_ticks_get();
+  } else {
+    stats_ = nullptr;
+  }
+}
+
+NativeCall::~NativeCall() {
+  if (stats_) {
+    stats_->Record(native_, status_, bytes_, handles_,
+                   zx_ticks_get() - start_);
+  }
+}
+
+}  // namespace dart
+}  // namespace zircon
@@ -0,0 +1,112 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DART_PKG_ZIRCON_SDK_EXT_NATIVE_STATS_H_
+#define DART_PKG_ZIRCON_SDK_EXT_NATIVE_STATS_H_
+
+#include <zircon/syscalls.h>
+#include <zircon/types.h>
+
+#include "src/lib/fxl/macros.h"
+
+namespace zircon {
+namespace dart {
+
+/**
+ * NativeStats counts the calls an isolate makes to the dart:zircon natives
+ * that move data or handles. For each native it keeps the number of calls,
+ * the number of calls that failed, not counting ZX_ERR_SHOULD_WAIT, the bytes and handles moved, and a
+ * histogram of call latencies. Waits are recorded like natives, with the time
+ * from arming the wait to its completion as the latency.
+ *
+ * All natives and wait completions of an isolate run on the isolate's
+ * thread, so the counters are plain integers and recording takes no locks.
+ * Recording is off until enabled, and then costs two tick reads per call.
+ */
+class NativeStats {
+ public:
+  enum Native {
+    kChannelWrite,
+    kChannelWriteV,
+    kChannelRead,
+    kChannelCall,
+    kChannelReadBatch,
+    kSocketWrite,
+    kSocketRead,
+    kVmoWrite,
+    kVmoRead,
+    kHandleClose,
+    kHandleCloseMany,
+    kHandleDuplicate,
+    kHandleReplace,
+    kHandleWait,
+    kNumNatives,
+  };
+
+  // The counters of each native, in this order, followed by the latency
+  // histogram. Latency bucket 0 counts calls under 1us, bucket i > 0 calls
+  // of [2^(i-1), 2^i) us, and the last bucket everything longer.
+  enum Field {
+    kCalls,
+    kErrors,
+    kBytes,
+    kHandles,
+    kLatencyBuckets,
+  };
+  static constexpr size_t kNumLatencyBuckets = 16;
+  static constexpr size_t kNumFields = kLatencyBuckets + kNumLatencyBuckets;
+
+  NativeStats() = default;
+
+  bool enabled() const { return enabled_; }
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // All counters, kNumFields per native, in the order of Native.
+  uint64_t* values() { return values_; }
+  static constexpr size_t kNumValues = kNumNatives * kNumFields;
+
+  static const char* Name(Native native);
+
+  void Record(Native native,
+              zx_status_t status,
+              uint64_t bytes,
+              uint64_t handles,
+              zx_ticks_t elapsed);
+
+ private:
+  bool enabled_ = false;
+  uint64_t values_[kNumValues] = {};
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(NativeStats);
+};
+
+/**
+ * NativeCall times one call of a native and records it in the current
+ * isolate's NativeStats when they are enabled. The status, bytes and handles
+ * of the call are reported with the setters before it goes out of scope.
+ */
+class NativeCall {
+ public:
+  explicit NativeCall(NativeStats::Native native);
+  ~NativeCall();
+
+  void set_status(zx_status_t status) { status_ = status; }
+  void add_bytes(uint64_t bytes) { bytes_ += bytes; }
+  void add_handles(uint64_t handles) { handles_ += handles; }
+
+ private:
+  NativeStats* stats_;
+  const NativeStats::Native native_;
+  zx_ticks_t start_ = 0;
+  zx_status_t status_ = ZX_OK;
+  uint64_t bytes_ = 0;
+  uint64_t handles_ = 0;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(NativeCall);
+};
+
+}  // namespace dart
+}  // namespace zircon
+
+#endif  // DART_PKG_ZIRCON_SDK_EXT_NATIVE_STATS_H_
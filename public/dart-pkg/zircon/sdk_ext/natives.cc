@@ -14,7 +14,10 @@
 
 #include "dart-pkg/zircon/sdk_ext/handle.h"
 #include "dart-pkg/zircon/sdk_ext/handle_waiter.h"
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+#include "dart-pkg/zircon/sdk_ext/leaf_natives.h"
 #include "dart-pkg/zircon/sdk_ext/system.h"
+#include "dart-pkg/zircon/sdk_ext/wait_port.h"
 #include "src/lib/fxl/arraysize.h"
 #include "src/lib/fxl/logging.h"
 #include "src/lib/fxl/macros.h"
@@ -40,6 +43,7 @@ tonic::DartLibraryNatives* InitNatives() {
   HandleWaiter::RegisterNatives(natives);
   Handle::RegisterNatives(natives);
   System::RegisterNatives(natives);
+  WaitPort::RegisterNatives(natives);
 
   return natives;
 }
@@ -53,6 +57,11 @@ Dart_NativeFunction NativeLookup(Dart_Handle name, int argument_count,
   }
   FXL_DCHECK(function_name != nullptr);
   FXL_DCHECK(auto_setup_scope != nullptr);
+  Dart_NativeFunction leaf = LookupLeafNative(function_name, argument_count);
+  if (leaf) {
+    *auto_setup_scope = false;
+    return leaf;
+  }
   *auto_setup_scope = true;
   if (!g_natives)
     g_natives = InitNatives();
@@ -60,6 +69,9 @@ Dart_NativeFunction NativeLookup(Dart_Handle name, int argument_count,
 }
 
 const uint8_t* NativeSymbol(Dart_NativeFunction native_function) {
+  if (const uint8_t* symbol = LeafNativeSymbol(native_function)) {
+    return symbol;
+  }
   if (!g_natives)
     g_natives = InitNatives();
   return g_natives->GetSymbol(native_function);
@@ -79,6 +91,8 @@ void Initialize() {
       new tonic::DartClassProvider(dart_state, "dart:zircon"));
   dart_state->class_library().add_provider("zircon",
                                            std::move(zircon_class_provider));
+
+  IsolateState::Create();
 }
 
 }  // namespace dart
@@ -4,22 +4,26 @@
 
 #include "dart-pkg/zircon/sdk_ext/system.h"
 
-#include <ddk/device.h>
 #include <fcntl.h>
 #include <fs/vfs.h>
-#include <fuchsia/device/manager/cpp/fidl.h>
 #include <lib/fdio/directory.h>
 #include <lib/fdio/io.h>
-#include <lib/fdio/limits.h>
 #include <lib/fdio/namespace.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <zircon/process.h>
 #include <zircon/processargs.h>
 
+#include <algorithm>
 #include <array>
+#include <memory>
 
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+#include "dart-pkg/zircon/sdk_ext/native_stats.h"
+#include "dart-pkg/zircon/sdk_ext/trace_sink.h"
 #include "src/lib/files/unique_fd.h"
+#include "src/lib/fxl/arraysize.h"
 #include "src/lib/fsl/io/fd.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_class_library.h"
@@ -31,14 +35,19 @@ namespace dart {
 
 namespace {
 
+constexpr char kHandle[] = "Handle";
 constexpr char kGetSizeResult[] = "GetSizeResult";
 constexpr char kHandlePairResult[] = "HandlePairResult";
 constexpr char kHandleResult[] = "HandleResult";
 constexpr char kReadResult[] = "ReadResult";
+constexpr char kReadBatchResult[] = "ReadBatchResult";
 constexpr char kWriteResult[] = "WriteResult";
 constexpr char kFromFileResult[] = "FromFileResult";
 constexpr char kMapResult[] = "MapResult";
 
+// The most messages Channel.readBatch reads in one call.
+constexpr uint32_t kMaxReadBatchMessages = 64;
+
 class ByteDataScope {
  public:
   explicit ByteDataScope(Dart_Handle dart_handle) : dart_handle_(dart_handle) {
@@ -48,6 +57,7 @@ class ByteDataScope {
   explicit ByteDataScope(size_t size) {
     dart_handle_ = Dart_NewTypedData(Dart_TypedData_kByteData, size);
     FXL_DCHECK(!tonic::LogIfError(dart_handle_));
+    IsolateState::Current()->CountAllocations(1);
     Acquire();
     FXL_DCHECK(size == size_);
   }
@@ -98,12 +108,12 @@ class ByteDataScope {
 };
 
 Dart_Handle MakeHandleList(const std::vector<zx_handle_t>& in_handles) {
-  tonic::DartClassLibrary& class_library =
-      tonic::DartState::Current()->class_library();
-  Dart_Handle handle_type = class_library.GetClass("zircon", "Handle");
+  IsolateState* isolate_state = IsolateState::Current();
+  Dart_Handle handle_type = isolate_state->GetClass(kHandle);
   Dart_Handle list = Dart_NewListOfType(handle_type, in_handles.size());
   if (Dart_IsError(list))
     return list;
+  isolate_state->CountAllocations(1 + in_handles.size());
   for (size_t i = 0; i < in_handles.size(); i++) {
     Dart_Handle result =
         Dart_ListSetAt(list, i, ToDart(Handle::Create(in_handles[i])));
@@ -113,13 +123,31 @@ Dart_Handle MakeHandleList(const std::vector<zx_handle_t>& in_handles) {
   return list;
 }
 
+Dart_Handle MakeUint32List(const std::vector<uint32_t>& values) {
+  Dart_Handle list =
+      Dart_NewTypedData(Dart_TypedData_kUint32, values.size());
+  if (Dart_IsError(list))
+    return list;
+  IsolateState::Current()->CountAllocations(1);
+  Dart_TypedData_Type type;
+  void* data = nullptr;
+  intptr_t length = 0;
+  Dart_Handle result = Dart_TypedDataAcquireData(list, &type, &data, &length);
+  if (Dart_IsError(result))
+    return result;
+  FXL_DCHECK(static_cast<size_t>(length) == values.size());
+  memcpy(data, values.data(), values.size() * sizeof(uint32_t));
+  result = Dart_TypedDataReleaseData(list);
+  if (Dart_IsError(result))
+    return result;
+  return list;
+}
+
 template <class... Args>
 Dart_Handle ConstructDartObject(const char* class_name, Args&&... args) {
-  tonic::DartClassLibrary& class_library =
-      tonic::DartState::Current()->class_library();
-  Dart_Handle type =
-      Dart_HandleFromPersistent(class_library.GetClass("zircon", class_name));
-  FXL_DCHECK(!tonic::LogIfError(type));
+  IsolateState* isolate_state = IsolateState::Current();
+  Dart_Handle type = isolate_state->GetClass(class_name);
+  isolate_state->CountAllocations(1);
 
   std::array<Dart_Handle, sizeof...(Args)> args_array{
       {std::forward<Args>(args)...}};
@@ -130,6 +158,13 @@ Dart_Handle ConstructDartObject(const char* class_name, Args&&... args) {
 }
 
 fdio_ns_t* GetNamespace() {
+  // The runner installs the namespace before the isolate runs any code, so
+  // it only has to be looked up once.
+  IsolateState* isolate_state = IsolateState::Current();
+  if (isolate_state->fdio_namespace()) {
+    return isolate_state->fdio_namespace();
+  }
+
   // Grab the fdio_ns_t* out of the isolate.
   Dart_Handle zircon_lib = Dart_LookupLibrary(ToDart("dart:zircon"));
   FXL_DCHECK(!tonic::LogIfError(zircon_lib));
@@ -143,7 +178,9 @@ fdio_ns_t* GetNamespace() {
   Dart_Handle result = Dart_IntegerToUint64(namespace_field, &fdio_ns_ptr);
   FXL_DCHECK(!tonic::LogIfError(result));
 
-  return reinterpret_cast<fdio_ns_t*>(fdio_ns_ptr);
+  fdio_ns_t* ns = reinterpret_cast<fdio_ns_t*>(fdio_ns_ptr);
+  isolate_state->set_fdio_namespace(ns);
+  return ns;
 }
 
 fxl::UniqueFD FdFromPath(std::string path) {
@@ -181,6 +218,26 @@ zx_status_t System::ConnectToService(std::string path,
                          channel->ReleaseHandle());
 }
 
+zx_status_t System::ConnectToServices(std::vector<std::string> paths,
+                                      std::vector<Handle*> channels) {
+  if (paths.size() != channels.size()) {
+    return ZX_ERR_INVALID_ARGS;
+  }
+
+  fdio_ns_t* ns = GetNamespace();
+  zx_status_t result = ZX_OK;
+  for (size_t i = 0; i < paths.size(); i++) {
+    // Channels are always consumed, even after a failure.
+    zx_status_t status = fdio_ns_connect(
+        ns, paths[i].c_str(), ZX_FS_RIGHT_READABLE | ZX_FS_RIGHT_WRITABLE,
+        channels[i]->ReleaseHandle());
+    if (result == ZX_OK) {
+      result = status;
+    }
+  }
+  return result;
+}
+
 Dart_Handle System::ChannelFromFile(std::string path) {
   fxl::UniqueFD fd = FdFromPath(path);
   if (!fd.is_valid()) {
@@ -200,8 +257,11 @@ Dart_Handle System::ChannelFromFile(std::string path) {
 zx_status_t System::ChannelWrite(fxl::RefPtr<Handle> channel,
                                  const tonic::DartByteData& data,
                                  std::vector<Handle*> handles) {
+  NativeCall stats(NativeStats::kChannelWrite);
+  TraceDuration trace("Channel.write");
   if (!channel || !channel->is_valid()) {
     data.Release();
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ZX_ERR_BAD_HANDLE;
   }
 
@@ -213,6 +273,12 @@ zx_status_t System::ChannelWrite(fxl::RefPtr<Handle> channel,
   zx_status_t status = zx_channel_write(channel->handle(), 0, data.data(),
                                         data.length_in_bytes(),
                                         zx_handles.data(), zx_handles.size());
+  if (status == ZX_OK) {
+    trace.FlowBegin(channel->handle(), data.data(), data.length_in_bytes());
+  }
+  stats.set_status(status);
+  stats.add_bytes(data.length_in_bytes());
+  stats.add_handles(zx_handles.size());
   // Handles are always consumed.
   for (Handle* handle : handles) {
     handle->ReleaseHandle();
@@ -222,44 +288,255 @@ zx_status_t System::ChannelWrite(fxl::RefPtr<Handle> channel,
   return status;
 }
 
-Dart_Handle System::ChannelQueryAndRead(fxl::RefPtr<Handle> channel) {
+zx_status_t System::ChannelWriteV(fxl::RefPtr<Handle> channel,
+                                  Dart_Handle segments,
+                                  std::vector<Handle*> handles) {
+  NativeCall stats(NativeStats::kChannelWriteV);
+  TraceDuration trace("Channel.write");
+  if (!channel || !channel->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
+  }
+
+  intptr_t num_segments = 0;
+  if (Dart_IsError(Dart_ListLength(segments, &num_segments))) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ZX_ERR_INVALID_ARGS;
+  }
+
+  // Gather the segments into the isolate's message buffer.
+  uint8_t* buffer = IsolateState::Current()->message_buffer();
+  size_t num_bytes = 0;
+  for (intptr_t i = 0; i < num_segments; i++) {
+    Dart_Handle segment = Dart_ListGetAt(segments, i);
+    Dart_TypedData_Type type;
+    void* data = nullptr;
+    intptr_t length = 0;
+    if (Dart_IsError(segment) ||
+        Dart_IsError(
+            Dart_TypedDataAcquireData(segment, &type, &data, &length))) {
+      stats.set_status(ZX_ERR_INVALID_ARGS);
+      return ZX_ERR_INVALID_ARGS;
+    }
+    const bool is_bytes =
+        type == Dart_TypedData_kByteData || type == Dart_TypedData_kUint8;
+    const bool fits =
+        static_cast<size_t>(length) <= ZX_CHANNEL_MAX_MSG_BYTES - num_bytes;
+    if (is_bytes && fits) {
+      memcpy(buffer + num_bytes, data, length);
+      num_bytes += length;
+    }
+    tonic::LogIfError(Dart_TypedDataReleaseData(segment));
+    if (!is_bytes) {
+      stats.set_status(ZX_ERR_INVALID_ARGS);
+      return ZX_ERR_INVALID_ARGS;
+    }
+    if (!fits) {
+      stats.set_status(ZX_ERR_OUT_OF_RANGE);
+      return ZX_ERR_OUT_OF_RANGE;
+    }
+  }
+
+  std::vector<zx_handle_t> zx_handles;
+  for (Handle* handle : handles) {
+    zx_handles.push_back(handle->handle());
+  }
+
+  zx_status_t status =
+      zx_channel_write(channel->handle(), 0, buffer, num_bytes,
+                       zx_handles.data(), zx_handles.size());
+  if (status == ZX_OK) {
+    trace.FlowBegin(channel->handle(), buffer, num_bytes);
+  }
+  stats.set_status(status);
+  stats.add_bytes(num_bytes);
+  stats.add_handles(zx_handles.size());
+  // Handles are always consumed.
+  for (Handle* handle : handles) {
+    handle->ReleaseHandle();
+  }
+
+  return status;
+}
+
+Dart_Handle System::ChannelRead(fxl::RefPtr<Handle> channel) {
+  NativeCall stats(NativeStats::kChannelRead);
+  TraceDuration trace("Channel.read");
   if (!channel || !channel->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ConstructDartObject(kReadResult, ToDart(ZX_ERR_BAD_HANDLE));
   }
 
+  // Channel messages are bounded, so a single read into a maximum sized
+  // buffer always succeeds without first querying the message size.
+  uint8_t* buffer = IsolateState::Current()->message_buffer();
+  zx_handle_t handles[ZX_CHANNEL_MAX_MSG_HANDLES];
   uint32_t actual_bytes = 0;
   uint32_t actual_handles = 0;
-
-  // Query the size of the next message.
-  zx_status_t status = zx_channel_read(channel->handle(), 0, nullptr, nullptr,
-                                       0, 0, &actual_bytes, &actual_handles);
-  if (status != ZX_ERR_BUFFER_TOO_SMALL) {
+  zx_status_t status = zx_channel_read(
+      channel->handle(), 0, buffer, handles, ZX_CHANNEL_MAX_MSG_BYTES,
+      ZX_CHANNEL_MAX_MSG_HANDLES, &actual_bytes, &actual_handles);
+  stats.set_status(status);
+  if (status != ZX_OK) {
     // An empty message or an error.
     return ConstructDartObject(kReadResult, ToDart(status));
   }
 
-  // Allocate space for the bytes and handles.
+  stats.add_bytes(actual_bytes);
+  stats.add_handles(actual_handles);
+  trace.FlowEnd(channel->handle(), buffer, actual_bytes);
+
   ByteDataScope bytes(actual_bytes);
   FXL_DCHECK(bytes.is_valid());
-  std::vector<zx_handle_t> handles(actual_handles);
+  memcpy(bytes.data(), buffer, actual_bytes);
+  bytes.Release();
+
+  return ConstructDartObject(
+      kReadResult, ToDart(status), bytes.dart_handle(), ToDart(actual_bytes),
+      MakeHandleList(std::vector<zx_handle_t>(handles,
+                                              handles + actual_handles)));
+}
 
-  // Make the call to actually get the message.
-  status = zx_channel_read(channel->handle(), 0, bytes.data(), handles.data(),
-                           bytes.size(), handles.size(), &actual_bytes,
-                           &actual_handles);
-  FXL_DCHECK(status != ZX_OK || bytes.size() == actual_bytes);
+Dart_Handle System::ChannelQueryAndRead(fxl::RefPtr<Handle> channel) {
+  return ChannelRead(std::move(channel));
+}
 
-  bytes.Release();
+Dart_Handle System::ChannelCall(fxl::RefPtr<Handle> channel,
+                                const tonic::DartByteData& data,
+                                std::vector<Handle*> handles,
+                                int64_t deadline) {
+  NativeCall stats(NativeStats::kChannelCall);
+  TraceDuration trace("Channel.call");
+  if (!channel || !channel->is_valid()) {
+    data.Release();
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ConstructDartObject(kReadResult, ToDart(ZX_ERR_BAD_HANDLE));
+  }
 
+  std::vector<zx_handle_t> zx_handles;
+  for (Handle* handle : handles) {
+    zx_handles.push_back(handle->handle());
+  }
+
+  uint8_t* buffer = IsolateState::Current()->message_buffer();
+  zx_handle_t rd_handles[ZX_CHANNEL_MAX_MSG_HANDLES];
+  zx_channel_call_args_t args = {};
+  args.wr_bytes = data.data();
+  args.wr_handles = zx_handles.data();
+  args.rd_bytes = buffer;
+  args.rd_handles = rd_handles;
+  args.wr_num_bytes = data.length_in_bytes();
+  args.wr_num_handles = zx_handles.size();
+  args.rd_num_bytes = ZX_CHANNEL_MAX_MSG_BYTES;
+  args.rd_num_handles = ZX_CHANNEL_MAX_MSG_HANDLES;
+  uint32_t actual_bytes = 0;
+  uint32_t actual_handles = 0;
+  const zx_ticks_t write_ticks = trace.enabled() ? zx_ticks_get() : 0;
+  zx_status_t status = zx_channel_call(channel->handle(), 0, deadline, &args,
+                                       &actual_bytes, &actual_handles);
+  stats.set_status(status);
+  stats.add_bytes(data.length_in_bytes());
+  stats.add_handles(zx_handles.size());
   if (status == ZX_OK) {
-    FXL_DCHECK(handles.size() == actual_handles);
+    stats.add_bytes(actual_bytes);
+    stats.add_handles(actual_handles);
+    // The kernel picks the request's txid, which the reply carries back, so
+    // the request's flow is reported now, as of its write.
+    trace.FlowBeginAt(write_ticks, channel->handle(), buffer, actual_bytes);
+    trace.FlowEnd(channel->handle(), buffer, actual_bytes);
+  }
+  // Handles are always consumed.
+  for (Handle* handle : handles) {
+    handle->ReleaseHandle();
+  }
+  data.Release();
 
-    // return a ReadResult object.
-    return ConstructDartObject(kReadResult, ToDart(status), bytes.dart_handle(),
-                               ToDart(actual_bytes), MakeHandleList(handles));
-  } else {
+  if (status != ZX_OK) {
     return ConstructDartObject(kReadResult, ToDart(status));
   }
+
+  ByteDataScope bytes(actual_bytes);
+  FXL_DCHECK(bytes.is_valid());
+  memcpy(bytes.data(), buffer, actual_bytes);
+  bytes.Release();
+
+  return ConstructDartObject(
+      kReadResult, ToDart(status), bytes.dart_handle(), ToDart(actual_bytes),
+      MakeHandleList(std::vector<zx_handle_t>(rd_handles,
+                                              rd_handles + actual_handles)));
+}
+
+Dart_Handle System::ChannelReadBatch(fxl::RefPtr<Handle> channel,
+                                     uint32_t max_messages,
+                                     uint32_t max_bytes) {
+  NativeCall stats(NativeStats::kChannelReadBatch);
+  TraceDuration trace("Channel.readBatch");
+  if (!channel || !channel->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ConstructDartObject(kReadBatchResult, ToDart(ZX_ERR_BAD_HANDLE));
+  }
+  if (max_messages == 0) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ConstructDartObject(kReadBatchResult, ToDart(ZX_ERR_INVALID_ARGS));
+  }
+
+  // Batches are bounded so that a caller cannot make this allocate more than
+  // a few MiB. The first message is always read, so the buffer must be able
+  // to hold a maximum sized message even when |max_bytes| is smaller than
+  // that.
+  max_messages = std::min(max_messages, kMaxReadBatchMessages);
+  max_bytes = std::min(max_bytes, max_messages * ZX_CHANNEL_MAX_MSG_BYTES);
+  const uint32_t capacity = std::max(max_bytes, ZX_CHANNEL_MAX_MSG_BYTES);
+  uint8_t* buffer = IsolateState::Current()->message_buffer(capacity);
+  std::vector<zx_handle_t> handles(max_messages * ZX_CHANNEL_MAX_MSG_HANDLES);
+  std::vector<uint32_t> byte_offsets{0};
+  std::vector<uint32_t> handle_offsets{0};
+
+  uint32_t total_bytes = 0;
+  uint32_t total_handles = 0;
+  zx_status_t status = ZX_OK;
+  for (uint32_t i = 0; i < max_messages; i++) {
+    const uint32_t available =
+        i == 0 ? capacity
+               : (max_bytes > total_bytes ? max_bytes - total_bytes : 0);
+
+    uint32_t actual_bytes = 0;
+    uint32_t actual_handles = 0;
+    status = zx_channel_read(channel->handle(), 0, buffer + total_bytes,
+                             handles.data() + total_handles, available,
+                             ZX_CHANNEL_MAX_MSG_HANDLES, &actual_bytes,
+                             &actual_handles);
+    if (status != ZX_OK) {
+      // ZX_ERR_BUFFER_TOO_SMALL leaves the message queued for the next batch.
+      break;
+    }
+
+    trace.FlowEnd(channel->handle(), buffer + total_bytes, actual_bytes);
+    total_bytes += actual_bytes;
+    total_handles += actual_handles;
+    byte_offsets.push_back(total_bytes);
+    handle_offsets.push_back(total_handles);
+  }
+  handles.resize(total_handles);
+
+  if (byte_offsets.size() == 1) {
+    // Nothing was read: report why.
+    stats.set_status(status);
+    return ConstructDartObject(kReadBatchResult, ToDart(status));
+  }
+
+  stats.add_bytes(total_bytes);
+  stats.add_handles(handles.size());
+
+  ByteDataScope bytes(total_bytes);
+  FXL_DCHECK(bytes.is_valid());
+  memcpy(bytes.data(), buffer, total_bytes);
+  bytes.Release();
+
+  return ConstructDartObject(kReadBatchResult, ToDart(ZX_OK),
+                             bytes.dart_handle(), MakeUint32List(byte_offsets),
+                             MakeUint32List(handle_offsets),
+                             MakeHandleList(handles));
 }
 
 Dart_Handle System::EventpairCreate(uint32_t options) {
@@ -288,20 +565,28 @@ Dart_Handle System::SocketCreate(uint32_t options) {
 
 Dart_Handle System::SocketWrite(fxl::RefPtr<Handle> socket,
                                 const tonic::DartByteData& data, int options) {
+  NativeCall stats(NativeStats::kSocketWrite);
   if (!socket || !socket->is_valid()) {
     data.Release();
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ConstructDartObject(kWriteResult, ToDart(ZX_ERR_BAD_HANDLE));
   }
 
   size_t actual;
   zx_status_t status = zx_socket_write(socket->handle(), options, data.data(),
                                        data.length_in_bytes(), &actual);
+  stats.set_status(status);
+  if (status == ZX_OK) {
+    stats.add_bytes(actual);
+  }
   data.Release();
   return ConstructDartObject(kWriteResult, ToDart(status), ToDart(actual));
 }
 
 Dart_Handle System::SocketRead(fxl::RefPtr<Handle> socket, size_t size) {
+  NativeCall stats(NativeStats::kSocketRead);
   if (!socket || !socket->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ConstructDartObject(kReadResult, ToDart(ZX_ERR_BAD_HANDLE));
   }
 
@@ -310,8 +595,10 @@ Dart_Handle System::SocketRead(fxl::RefPtr<Handle> socket, size_t size) {
   zx_status_t status =
       zx_socket_read(socket->handle(), 0, bytes.data(), size, &actual);
   bytes.Release();
+  stats.set_status(status);
   if (status == ZX_OK) {
     FXL_DCHECK(actual <= size);
+    stats.add_bytes(actual);
     return ConstructDartObject(kReadResult, ToDart(status), bytes.dart_handle(),
                                ToDart(actual));
   }
@@ -319,6 +606,39 @@ Dart_Handle System::SocketRead(fxl::RefPtr<Handle> socket, size_t size) {
   return ConstructDartObject(kReadResult, ToDart(status));
 }
 
+zx_status_t System::SocketReadInto(fxl::RefPtr<Handle> socket,
+                                   Dart_Handle target,
+                                   size_t target_offset,
+                                   size_t size) {
+  NativeCall stats(NativeStats::kSocketRead);
+  uint64_t* out_values = IsolateState::Current()->out_values();
+  out_values[IsolateState::kOutNumBytes] = 0;
+  if (!socket || !socket->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
+  }
+
+  ByteDataScope bytes(target);
+  if (!bytes.is_valid()) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ZX_ERR_INVALID_ARGS;
+  }
+  if (target_offset > bytes.size() || size > bytes.size() - target_offset) {
+    stats.set_status(ZX_ERR_OUT_OF_RANGE);
+    return ZX_ERR_OUT_OF_RANGE;
+  }
+
+  size_t actual = 0;
+  zx_status_t status =
+      zx_socket_read(socket->handle(), 0,
+                     static_cast<uint8_t*>(bytes.data()) + target_offset,
+                     size, &actual);
+  out_values[IsolateState::kOutNumBytes] = actual;
+  stats.set_status(status);
+  stats.add_bytes(actual);
+  return status;
+}
+
 Dart_Handle System::VmoCreate(uint64_t size, uint32_t options) {
   zx_handle_t vmo = ZX_HANDLE_INVALID;
   zx_status_t status = zx_vmo_create(size, options, &vmo);
@@ -368,13 +688,19 @@ zx_status_t System::VmoSetSize(fxl::RefPtr<Handle> vmo, uint64_t size) {
 
 zx_status_t System::VmoWrite(fxl::RefPtr<Handle> vmo, uint64_t offset,
                              const tonic::DartByteData& data) {
+  NativeCall stats(NativeStats::kVmoWrite);
   if (!vmo || !vmo->is_valid()) {
     data.Release();
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ZX_ERR_BAD_HANDLE;
   }
 
   zx_status_t status =
       zx_vmo_write(vmo->handle(), data.data(), offset, data.length_in_bytes());
+  stats.set_status(status);
+  if (status == ZX_OK) {
+    stats.add_bytes(data.length_in_bytes());
+  }
 
   data.Release();
   return status;
@@ -382,7 +708,9 @@ zx_status_t System::VmoWrite(fxl::RefPtr<Handle> vmo, uint64_t offset,
 
 Dart_Handle System::VmoRead(fxl::RefPtr<Handle> vmo, uint64_t offset,
                             size_t size) {
+  NativeCall stats(NativeStats::kVmoRead);
   if (!vmo || !vmo->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
     return ConstructDartObject(kReadResult, ToDart(ZX_ERR_BAD_HANDLE));
   }
 
@@ -390,13 +718,47 @@ Dart_Handle System::VmoRead(fxl::RefPtr<Handle> vmo, uint64_t offset,
   ByteDataScope bytes(size);
   zx_status_t status = zx_vmo_read(vmo->handle(), bytes.data(), offset, size);
   bytes.Release();
+  stats.set_status(status);
   if (status == ZX_OK) {
+    stats.add_bytes(size);
     return ConstructDartObject(kReadResult, ToDart(status), bytes.dart_handle(),
                                ToDart(size));
   }
   return ConstructDartObject(kReadResult, ToDart(status));
 }
 
+zx_status_t System::VmoReadInto(fxl::RefPtr<Handle> vmo,
+                                uint64_t offset,
+                                Dart_Handle target,
+                                size_t target_offset,
+                                size_t size) {
+  NativeCall stats(NativeStats::kVmoRead);
+  if (!vmo || !vmo->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
+  }
+
+  ByteDataScope bytes(target);
+  if (!bytes.is_valid()) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ZX_ERR_INVALID_ARGS;
+  }
+  if (target_offset > bytes.size() || size > bytes.size() - target_offset) {
+    stats.set_status(ZX_ERR_OUT_OF_RANGE);
+    return ZX_ERR_OUT_OF_RANGE;
+  }
+
+  zx_status_t status =
+      zx_vmo_read(vmo->handle(),
+                  static_cast<uint8_t*>(bytes.data()) + target_offset, offset,
+                  size);
+  stats.set_status(status);
+  if (status == ZX_OK) {
+    stats.add_bytes(size);
+  }
+  return status;
+}
+
 struct SizedRegion {
   SizedRegion(void* r, size_t s) : region(r), size(s) {}
   void* region;
@@ -412,59 +774,438 @@ void System::VmoMapFinalizer(void* isolate_callback_data,
 }
 
 Dart_Handle System::VmoMap(fxl::RefPtr<Handle> vmo) {
+  return VmoMapRange(std::move(vmo), 0, 0, ZX_VM_PERM_READ);
+}
+
+namespace {
+
+constexpr uint32_t kVmoMapFlags =
+    ZX_VM_PERM_READ | ZX_VM_PERM_WRITE | ZX_VM_MAP_RANGE;
+
+// Validates |offset| and |length| against the size of |vmo|, resolving a zero
+// |length| to the rest of the VMO, and computes the page-aligned range that
+// has to be mapped to cover them.
+zx_status_t GetMapRange(zx_handle_t vmo,
+                        uint64_t offset,
+                        uint64_t* length,
+                        uint64_t* map_offset,
+                        uint64_t* map_size) {
+  uint64_t size;
+  zx_status_t status = zx_vmo_get_size(vmo, &size);
+  if (status != ZX_OK)
+    return status;
+  if (offset > size)
+    return ZX_ERR_OUT_OF_RANGE;
+  if (*length == 0)
+    *length = size - offset;
+  if (*length > size - offset)
+    return ZX_ERR_OUT_OF_RANGE;
+
+  const uint64_t page_size = zx_system_get_page_size();
+  *map_offset = offset - offset % page_size;
+  *map_size =
+      (offset + *length - *map_offset + page_size - 1) / page_size * page_size;
+  return ZX_OK;
+}
+
+}  // namespace
+
+Dart_Handle System::VmoMapRange(fxl::RefPtr<Handle> vmo,
+                                uint64_t offset,
+                                uint64_t length,
+                                uint32_t flags) {
   if (!vmo || !vmo->is_valid())
     return ConstructDartObject(kMapResult, ToDart(ZX_ERR_BAD_HANDLE));
+  if (flags & ~kVmoMapFlags)
+    return ConstructDartObject(kMapResult, ToDart(ZX_ERR_INVALID_ARGS));
 
-  uint64_t size;
-  zx_status_t status = zx_vmo_get_size(vmo->handle(), &size);
+  return MapToTypedData(vmo->handle(), offset, length, flags);
+}
+
+Dart_Handle System::MapToTypedData(zx_handle_t vmo,
+                                   uint64_t offset,
+                                   uint64_t length,
+                                   uint32_t flags) {
+  uint64_t map_offset, map_size;
+  zx_status_t status =
+      GetMapRange(vmo, offset, &length, &map_offset, &map_size);
   if (status != ZX_OK)
     return ConstructDartObject(kMapResult, ToDart(status));
 
+  // Mappings must be page aligned, so map the enclosing pages and hand out a
+  // view of the requested range.
   uintptr_t mapped_addr;
-  status = zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ, 0, vmo->handle(),
-                       0, size, &mapped_addr);
+  status = zx_vmar_map(zx_vmar_root_self(), ZX_VM_PERM_READ | flags, 0, vmo,
+                       map_offset, map_size, &mapped_addr);
   if (status != ZX_OK)
     return ConstructDartObject(kMapResult, ToDart(status));
 
-  void* data = reinterpret_cast<void*>(mapped_addr);
+  void* data = reinterpret_cast<void*>(mapped_addr + (offset - map_offset));
   Dart_Handle object = Dart_NewExternalTypedData(Dart_TypedData_kUint8, data,
-                                                 static_cast<intptr_t>(size));
+                                                 static_cast<intptr_t>(length));
   FXL_DCHECK(!tonic::LogIfError(object));
 
-  SizedRegion* r = new SizedRegion(data, size);
+  SizedRegion* r =
+      new SizedRegion(reinterpret_cast<void*>(mapped_addr), map_size);
   Dart_NewWeakPersistentHandle(object, reinterpret_cast<void*>(r),
-                               static_cast<intptr_t>(size) + sizeof(*r),
+                               static_cast<intptr_t>(map_size) + sizeof(*r),
                                System::VmoMapFinalizer);
 
   return ConstructDartObject(kMapResult, ToDart(ZX_OK), object);
 }
 
+Dart_Handle System::MapFile(std::string path,
+                            uint64_t offset,
+                            uint64_t length,
+                            bool exact) {
+  fxl::UniqueFD fd = FdFromPath(path);
+  if (!fd.is_valid())
+    return ConstructDartObject(kMapResult, ToDart(ZX_ERR_IO));
+
+  // The file's VMO is rounded up to whole pages, so the file size is only
+  // needed when the caller leaves the length to the end of the file.
+  if (length == 0) {
+    struct stat stat_struct;
+    if (fstat(fd.get(), &stat_struct) == -1)
+      return ConstructDartObject(kMapResult, ToDart(ZX_ERR_IO));
+    const uint64_t file_size = stat_struct.st_size;
+    if (offset > file_size)
+      return ConstructDartObject(kMapResult, ToDart(ZX_ERR_OUT_OF_RANGE));
+    length = file_size - offset;
+    if (length == 0) {
+      Dart_Handle empty = Dart_NewTypedData(Dart_TypedData_kUint8, 0);
+      return ConstructDartObject(kMapResult, ToDart(ZX_OK), empty);
+    }
+  }
+
+  // An exact VMO maps the file's own pages. A clone is a copy-on-write child
+  // that is isolated from later changes to the file.
+  zx_handle_t vmo = ZX_HANDLE_INVALID;
+  zx_status_t status = exact ? fdio_get_vmo_exact(fd.get(), &vmo)
+                             : fdio_get_vmo_clone(fd.get(), &vmo);
+  if (status != ZX_OK)
+    return ConstructDartObject(kMapResult, ToDart(status));
+
+  // The mapping keeps the VMO alive, so the handle can go right away.
+  Dart_Handle result = MapToTypedData(vmo, offset, length, 0);
+  zx_handle_close(vmo);
+  return result;
+}
+
+void System::VmoRegionFinalizer(void* isolate_callback_data,
+                                Dart_WeakPersistentHandle handle,
+                                void* peer) {
+  zx_handle_t region =
+      static_cast<zx_handle_t>(reinterpret_cast<uintptr_t>(peer));
+  zx_vmar_destroy(region);
+  zx_handle_close(region);
+}
+
+Dart_Handle System::VmoMapRegion(fxl::RefPtr<Handle> vmo,
+                                 uint64_t offset,
+                                 uint64_t length,
+                                 uint32_t flags) {
+  if (!vmo || !vmo->is_valid())
+    return ConstructDartObject(kMapResult, ToDart(ZX_ERR_BAD_HANDLE));
+  if (flags & ~kVmoMapFlags)
+    return ConstructDartObject(kMapResult, ToDart(ZX_ERR_INVALID_ARGS));
+
+  uint64_t map_offset, map_size;
+  zx_status_t status =
+      GetMapRange(vmo->handle(), offset, &length, &map_offset, &map_size);
+  if (status != ZX_OK)
+    return ConstructDartObject(kMapResult, ToDart(status));
+
+  // The mapping lives in its own sub-region so that its address range stays
+  // reserved after VmoUnmap: a stale view never aliases some later mapping.
+  // The region itself is only destroyed once the typed data has been
+  // collected.
+  zx_vm_option_t region_options = ZX_VM_CAN_MAP_READ | ZX_VM_CAN_MAP_SPECIFIC;
+  if (flags & ZX_VM_PERM_WRITE)
+    region_options |= ZX_VM_CAN_MAP_WRITE;
+  zx_handle_t region = ZX_HANDLE_INVALID;
+  uintptr_t region_addr;
+  status = zx_vmar_allocate(zx_vmar_root_self(), region_options, 0, map_size,
+                            &region, &region_addr);
+  if (status != ZX_OK)
+    return ConstructDartObject(kMapResult, ToDart(status));
+
+  uintptr_t mapped_addr;
+  zx_handle_t finalizer_region = ZX_HANDLE_INVALID;
+  status = zx_vmar_map(region, ZX_VM_SPECIFIC | ZX_VM_PERM_READ | flags, 0,
+                       vmo->handle(), map_offset, map_size, &mapped_addr);
+  if (status == ZX_OK)
+    status = zx_handle_duplicate(region, ZX_RIGHT_SAME_RIGHTS,
+                                 &finalizer_region);
+  if (status != ZX_OK) {
+    zx_vmar_destroy(region);
+    zx_handle_close(region);
+    return ConstructDartObject(kMapResult, ToDart(status));
+  }
+
+  void* data = reinterpret_cast<void*>(mapped_addr + (offset - map_offset));
+  Dart_Handle object = Dart_NewExternalTypedData(Dart_TypedData_kUint8, data,
+                                                 static_cast<intptr_t>(length));
+  FXL_DCHECK(!tonic::LogIfError(object));
+
+  // The pages are released by an explicit unmap, so the GC is only charged
+  // for the bookkeeping rather than the size of the mapping.
+  Dart_NewWeakPersistentHandle(
+      object, reinterpret_cast<void*>(static_cast<uintptr_t>(finalizer_region)),
+      sizeof(zx_handle_t), System::VmoRegionFinalizer);
+
+  return ConstructDartObject(kMapResult, ToDart(ZX_OK), object,
+                             ToDart(Handle::Create(region)));
+}
+
+zx_status_t System::VmoUnmap(fxl::RefPtr<Handle> region) {
+  if (!region || !region->is_valid())
+    return ZX_ERR_BAD_HANDLE;
+
+  zx_info_vmar_t info;
+  zx_status_t status =
+      zx_object_get_info(region->handle(), ZX_INFO_VMAR, &info, sizeof(info),
+                         nullptr, nullptr);
+  if (status != ZX_OK)
+    return status;
+
+  // Views of the mapping can outlive it. Instead of leaving the range
+  // unmapped, the VMO's pages are replaced with those of an empty VMO, mapped
+  // read-only: a stale read sees zeros without committing memory, and a
+  // stale write faults rather than quietly allocating pages.
+  zx_handle_t empty_vmo;
+  status = zx_vmo_create(info.len, 0, &empty_vmo);
+  if (status != ZX_OK)
+    return status;
+  uintptr_t mapped_addr;
+  status = zx_vmar_map(region->handle(),
+                       ZX_VM_SPECIFIC_OVERWRITE | ZX_VM_PERM_READ, 0, empty_vmo,
+                       0, info.len, &mapped_addr);
+  zx_handle_close(empty_vmo);
+  return status;
+}
+
 uint64_t System::ClockGet(uint32_t clock_id) {
   zx_time_t result = 0;
   zx_clock_get(clock_id, &result);
   return result;
 }
 
+zx_status_t System::HandleCloseMany(std::vector<Handle*> handles) {
+  NativeCall stats(NativeStats::kHandleCloseMany);
+  std::vector<zx_handle_t> zx_handles;
+  zx_handles.reserve(handles.size());
+  for (Handle* handle : handles) {
+    if (handle && handle->is_valid()) {
+      zx_handles.push_back(handle->ReleaseHandle());
+    }
+  }
+  zx_status_t status =
+      zx_handle_close_many(zx_handles.data(), zx_handles.size());
+  stats.set_status(status);
+  stats.add_handles(zx_handles.size());
+  return status;
+}
+
+Dart_Handle System::GetOutValues() {
+  IsolateState* state = IsolateState::Current();
+  Dart_Handle object =
+      Dart_NewExternalTypedData(Dart_TypedData_kUint64, state->out_values(),
+                                IsolateState::kNumOutValues);
+  FXL_DCHECK(!tonic::LogIfError(object));
+  return object;
+}
+
+zx_status_t System::SocketWriteRaw(fxl::RefPtr<Handle> socket,
+                                   const tonic::DartByteData& data,
+                                   int options) {
+  NativeCall stats(NativeStats::kSocketWrite);
+  uint64_t* out_values = IsolateState::Current()->out_values();
+  out_values[IsolateState::kOutNumBytes] = 0;
+  if (!socket || !socket->is_valid()) {
+    data.Release();
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
+  }
+
+  size_t actual = 0;
+  zx_status_t status = zx_socket_write(socket->handle(), options, data.data(),
+                                       data.length_in_bytes(), &actual);
+  stats.set_status(status);
+  stats.add_bytes(actual);
+  data.Release();
+  out_values[IsolateState::kOutNumBytes] = actual;
+  return status;
+}
+
+zx_status_t System::VmoGetSizeRaw(Handle* vmo) {
+  uint64_t* out_values = IsolateState::Current()->out_values();
+  out_values[IsolateState::kOutSize] = 0;
+  if (!vmo || !vmo->is_valid()) {
+    return ZX_ERR_BAD_HANDLE;
+  }
+  return zx_vmo_get_size(vmo->handle(), &out_values[IsolateState::kOutSize]);
+}
+
+zx_status_t System::ChannelReadInto(fxl::RefPtr<Handle> channel,
+                                    Dart_Handle target,
+                                    Dart_Handle handles) {
+  NativeCall stats(NativeStats::kChannelRead);
+  TraceDuration trace("Channel.read");
+  uint64_t* out_values = IsolateState::Current()->out_values();
+  out_values[IsolateState::kOutNumBytes] = 0;
+  out_values[IsolateState::kOutNumHandles] = 0;
+  if (!channel || !channel->is_valid()) {
+    stats.set_status(ZX_ERR_BAD_HANDLE);
+    return ZX_ERR_BAD_HANDLE;
+  }
+
+  intptr_t handles_length = 0;
+  if (!Dart_IsNull(handles) &&
+      Dart_IsError(Dart_ListLength(handles, &handles_length))) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ZX_ERR_INVALID_ARGS;
+  }
+  ByteDataScope bytes(target);
+  if (!bytes.is_valid()) {
+    stats.set_status(ZX_ERR_INVALID_ARGS);
+    return ZX_ERR_INVALID_ARGS;
+  }
+
+  // On ZX_ERR_BUFFER_TOO_SMALL the message stays queued and the actual
+  // counts are the sizes it needs.
+  zx_handle_t zx_handles[ZX_CHANNEL_MAX_MSG_HANDLES];
+  uint32_t actual_bytes = 0;
+  uint32_t actual_handles = 0;
+  zx_status_t status = zx_channel_read(
+      channel->handle(), 0, bytes.data(), zx_handles,
+      std::min<size_t>(bytes.size(), ZX_CHANNEL_MAX_MSG_BYTES),
+      std::min<intptr_t>(handles_length, ZX_CHANNEL_MAX_MSG_HANDLES),
+      &actual_bytes, &actual_handles);
+  out_values[IsolateState::kOutNumBytes] = actual_bytes;
+  out_values[IsolateState::kOutNumHandles] = actual_handles;
+  stats.set_status(status);
+  if (status != ZX_OK) {
+    return status;
+  }
+
+  stats.add_bytes(actual_bytes);
+  stats.add_handles(actual_handles);
+  trace.FlowEnd(channel->handle(), bytes.data(), actual_bytes);
+  // Handles can only be created once the bytes are released.
+  bytes.Release();
+
+  IsolateState::Current()->CountAllocations(actual_handles);
+  for (uint32_t i = 0; i < actual_handles; i++) {
+    Dart_Handle result =
+        Dart_ListSetAt(handles, i, ToDart(Handle::Create(zx_handles[i])));
+    if (Dart_IsError(result)) {
+      // The Handle that failed to be stored closes its handle when it is
+      // finalized; the rest are closed here.
+      if (i + 1 < actual_handles) {
+        zx_handle_close_many(&zx_handles[i + 1], actual_handles - i - 1);
+      }
+      return ZX_ERR_INVALID_ARGS;
+    }
+  }
+  return ZX_OK;
+}
+
+uint64_t System::GetNativeAllocations() {
+  return IsolateState::Current()->allocations();
+}
+
+void System::SetNativeStatsEnabled(bool enabled) {
+  IsolateState::Current()->native_stats().set_enabled(enabled);
+}
+
+Dart_Handle System::GetNativeStats() {
+  NativeStats& stats = IsolateState::Current()->native_stats();
+  Dart_Handle object =
+      Dart_NewExternalTypedData(Dart_TypedData_kUint64, stats.values(),
+                                NativeStats::kNumValues);
+  FXL_DCHECK(!tonic::LogIfError(object));
+  return object;
+}
+
+std::vector<std::string> System::GetNativeStatsNames() {
+  std::vector<std::string> names;
+  for (int i = 0; i < NativeStats::kNumNatives; i++) {
+    names.push_back(NativeStats::Name(static_cast<NativeStats::Native>(i)));
+  }
+  return names;
+}
+
+zx_status_t System::SetTraceFile(std::string path) {
+  if (path.empty()) {
+    SetTraceSink(nullptr);
+    return ZX_OK;
+  }
+  std::shared_ptr<FileTraceSink> sink = FileTraceSink::Create(path);
+  if (!sink) {
+    return ZX_ERR_IO;
+  }
+  SetTraceSink(std::move(sink));
+  return ZX_OK;
+}
+
+zx_ticks_t System::TraceBegin() {
+  return GetTraceSink() ? zx_ticks_get() : 0;
+}
+
+void System::TraceEnd(int event, zx_ticks_t start, uint64_t ordinal) {
+  // Event names as numbered in dart:zircon's System.
+  static const char* const kEventNames[] = {
+      "fidl.encode",
+      "fidl.decode",
+  };
+  if (start == 0 || event < 0 ||
+      static_cast<size_t>(event) >= arraysize(kEventNames)) {
+    return;
+  }
+  if (std::shared_ptr<TraceSink> sink = GetTraceSink()) {
+    sink->Duration(kEventNames[event], start, zx_ticks_get(), ordinal);
+  }
+}
+
 // clang-format: off
 
 #define FOR_EACH_STATIC_BINDING(V) \
   V(System, ChannelCreate)         \
   V(System, ChannelFromFile)       \
   V(System, ChannelWrite)          \
+  V(System, ChannelWriteV)         \
+  V(System, ChannelRead)           \
   V(System, ChannelQueryAndRead)   \
+  V(System, ChannelCall)           \
+  V(System, ChannelReadBatch)      \
   V(System, EventpairCreate)       \
   V(System, ConnectToService)      \
+  V(System, ConnectToServices)     \
   V(System, SocketCreate)          \
   V(System, SocketWrite)           \
   V(System, SocketRead)            \
+  V(System, SocketReadInto)        \
   V(System, VmoCreate)             \
   V(System, VmoFromFile)           \
   V(System, VmoGetSize)            \
   V(System, VmoSetSize)            \
   V(System, VmoRead)               \
+  V(System, VmoReadInto)           \
   V(System, VmoWrite)              \
   V(System, VmoMap)                \
-  V(System, ClockGet)
+  V(System, VmoMapRange)           \
+  V(System, VmoMapRegion)          \
+  V(System, VmoUnmap)              \
+  V(System, MapFile)               \
+  V(System, HandleCloseMany)       \
+  V(System, GetOutValues)          \
+  V(System, SocketWriteRaw)        \
+  V(System, ChannelReadInto)       \
+  V(System, SetNativeStatsEnabled) \
+  V(System, GetNativeStats)        \
+  V(System, GetNativeStatsNames)   \
+  V(System, SetTraceFile)
 
 // clang-format: on
 
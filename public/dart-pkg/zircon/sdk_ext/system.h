@@ -28,8 +28,28 @@ class System : public fxl::RefCountedThreadSafe<System>,
   static zx_status_t ChannelWrite(fxl::RefPtr<Handle> channel,
                                   const tonic::DartByteData& data,
                                   std::vector<Handle*> handles);
-  // TODO(ianloic): Add ChannelRead
+  // Writes one message assembled from a list of ByteData or Uint8List
+  // |segments|, copying them natively into a single buffer.
+  static zx_status_t ChannelWriteV(fxl::RefPtr<Handle> channel,
+                                   Dart_Handle segments,
+                                   std::vector<Handle*> handles);
+  // Reads the next message with a single syscall, using the isolate's
+  // scratch buffer, and returns an exactly sized copy of its bytes.
+  static Dart_Handle ChannelRead(fxl::RefPtr<Handle> channel);
   static Dart_Handle ChannelQueryAndRead(fxl::RefPtr<Handle> channel);
+  // Writes |data| and |handles| and waits until |deadline| for the reply with
+  // the matching txid, which the kernel assigns. The reply is read into the
+  // isolate's scratch buffer.
+  static Dart_Handle ChannelCall(fxl::RefPtr<Handle> channel,
+                                 const tonic::DartByteData& data,
+                                 std::vector<Handle*> handles,
+                                 int64_t deadline);
+  // Reads up to |max_messages| queued messages, packing their bytes into one
+  // buffer. Reading stops early when the next message would push the total
+  // past |max_bytes|, but the first message is always returned.
+  static Dart_Handle ChannelReadBatch(fxl::RefPtr<Handle> channel,
+                                      uint32_t max_messages,
+                                      uint32_t max_bytes);
 
   static Dart_Handle EventpairCreate(uint32_t options);
 
@@ -38,6 +58,12 @@ class System : public fxl::RefCountedThreadSafe<System>,
                                  const tonic::DartByteData& data,
                                  int options);
   static Dart_Handle SocketRead(fxl::RefPtr<Handle> socket, size_t size);
+  // Reads up to |size| bytes into |target| at |target_offset|. The number of
+  // bytes read is left in the isolate's first out value.
+  static zx_status_t SocketReadInto(fxl::RefPtr<Handle> socket,
+                                    Dart_Handle target,
+                                    size_t target_offset,
+                                    size_t size);
 
   static Dart_Handle VmoCreate(uint64_t size, uint32_t options);
   static Dart_Handle VmoFromFile(std::string path);
@@ -49,19 +75,100 @@ class System : public fxl::RefCountedThreadSafe<System>,
   static Dart_Handle VmoRead(fxl::RefPtr<Handle> vmo,
                              uint64_t offset,
                              size_t size);
+  // Reads |size| bytes at |offset| into |target| at |target_offset|.
+  static zx_status_t VmoReadInto(fxl::RefPtr<Handle> vmo,
+                                 uint64_t offset,
+                                 Dart_Handle target,
+                                 size_t target_offset,
+                                 size_t size);
 
   static Dart_Handle VmoMap(fxl::RefPtr<Handle> vmo);
+  // Maps |length| bytes of |vmo| starting at |offset|, or the rest of the VMO
+  // when |length| is zero. |flags| may add ZX_VM_PERM_WRITE to the read
+  // permission every mapping gets, and ZX_VM_MAP_RANGE to prefault it.
+  static Dart_Handle VmoMapRange(fxl::RefPtr<Handle> vmo,
+                                 uint64_t offset,
+                                 uint64_t length,
+                                 uint32_t flags);
+  // Like VmoMapRange, but the mapping is placed in a sub-region of the root
+  // vmar whose handle is returned, so it can be released with VmoUnmap
+  // without waiting for the GC. VmoUnmap leaves read-only empty pages in its
+  // place, and the address range stays reserved until the GC collects the
+  // mapped typed data.
+  static Dart_Handle VmoMapRegion(fxl::RefPtr<Handle> vmo,
+                                  uint64_t offset,
+                                  uint64_t length,
+                                  uint32_t flags);
+  static zx_status_t VmoUnmap(fxl::RefPtr<Handle> region);
+
+  // Maps |length| bytes of the file at |path| starting at |offset|, or the
+  // rest of the file when |length| is zero, read-only and without copying.
+  // With |exact| the file's own VMO is mapped instead of a copy-on-write
+  // clone. The file is only stat'ed when |length| is zero.
+  static Dart_Handle MapFile(std::string path,
+                             uint64_t offset,
+                             uint64_t length,
+                             bool exact);
 
+  // ClockGet, VmoGetSizeRaw and GetNativeAllocations are bound as leaf
+  // natives; see leaf_natives.h.
   static uint64_t ClockGet(uint32_t clock_id);
 
+  // Closes all valid |handles| with a single syscall, cancelling their
+  // pending waits first.
+  static zx_status_t HandleCloseMany(std::vector<Handle*> handles);
+
+  // Allocation-free variants of the natives above. They return the status
+  // and store any other result in the isolate's out values.
+  static Dart_Handle GetOutValues();
+  static zx_status_t SocketWriteRaw(fxl::RefPtr<Handle> socket,
+                                    const tonic::DartByteData& data,
+                                    int options);
+  static zx_status_t VmoGetSizeRaw(Handle* vmo);
+  // Reads the next message into the ByteData |target| and its handles into
+  // the first entries of the list |handles|, which may be null if no handles
+  // are expected.
+  static zx_status_t ChannelReadInto(fxl::RefPtr<Handle> channel,
+                                     Dart_Handle target,
+                                     Dart_Handle handles);
+  // The number of Dart objects natives have allocated for their results in
+  // this isolate. Bound as a leaf native.
+  static uint64_t GetNativeAllocations();
+
+  // Instrumentation. The counters of NativeStats are exposed to Dart as a
+  // Uint64List over the isolate's own storage, so reading them is free.
+  static void SetNativeStatsEnabled(bool enabled);
+  static Dart_Handle GetNativeStats();
+  static std::vector<std::string> GetNativeStatsNames();
+
+  // Traces to the file at |path| (see FileTraceSink), or stops tracing if
+  // |path| is empty. TraceBegin and TraceEnd, for Dart code that traces
+  // FIDL encoding and decoding, are bound as leaf natives.
+  static zx_status_t SetTraceFile(std::string path);
+  static zx_ticks_t TraceBegin();
+  static void TraceEnd(int event, zx_ticks_t start, uint64_t ordinal);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
   static zx_status_t ConnectToService(std::string path, fxl::RefPtr<Handle> channel);
+  // Connects each channel to the service at the matching path in the
+  // isolate's namespace. All channels are consumed; the first failure, if
+  // any, is returned.
+  static zx_status_t ConnectToServices(std::vector<std::string> paths,
+                                       std::vector<Handle*> channels);
 
  private:
+  // Maps a range of |vmo| as VmoMapRange does, returning a MapResult.
+  static Dart_Handle MapToTypedData(zx_handle_t vmo,
+                                    uint64_t offset,
+                                    uint64_t length,
+                                    uint32_t flags);
   static void VmoMapFinalizer(void* isolate_callback_data,
                               Dart_WeakPersistentHandle handle,
                               void* peer);
+  static void VmoRegionFinalizer(void* isolate_callback_data,
+                                 Dart_WeakPersistentHandle handle,
+                                 void* peer);
 };
 
 }  // namespace dart
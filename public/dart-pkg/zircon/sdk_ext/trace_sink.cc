@@ -0,0 +1,280 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dart-pkg/zircon/sdk_ext/trace_sink.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <zircon/process.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/object.h>
+
+#include <atomic>
+#include <unordered_map>
+
+#include "src/lib/fxl/logging.h"
+
+namespace zircon {
+namespace dart {
+namespace {
+
+// The FIDL message header: txid at 0, ordinal at 8.
+constexpr size_t kMessageHeaderSize = 16;
+constexpr size_t kMessageTxidOffset = 0;
+constexpr size_t kMessageOrdinalOffset = 8;
+
+std::mutex g_sink_mutex;
+std::shared_ptr<TraceSink>* g_sink;
+std::atomic<bool> g_tracing(false);
+
+zx_koid_t GetKoid(zx_handle_t handle, bool related) {
+  zx_info_handle_basic_t info;
+  zx_status_t status = zx_object_get_info(handle, ZX_INFO_HANDLE_BASIC, &info,
+                                          sizeof(info), nullptr, nullptr);
+  if (status != ZX_OK) {
+    return ZX_KOID_INVALID;
+  }
+  return related ? info.related_koid : info.koid;
+}
+
+// Set in the flow ids of one-way messages, whose sequence numbers could
+// otherwise equal a txid on the same channel.
+constexpr uint64_t kOneWayFlow = 1ull << 63;
+
+// The number of one-way messages written to and read from each channel
+// while tracing, keyed by the koid of the endpoint they were written to.
+// Channels keep messages in order, so the n-th one written is the n-th one
+// read.
+struct FlowSequences {
+  std::unordered_map<zx_koid_t, uint32_t> written;
+  std::unordered_map<zx_koid_t, uint32_t> read;
+};
+std::mutex g_sequences_mutex;
+FlowSequences* g_sequences;
+
+uint32_t NextSequence(bool written, zx_koid_t writer_koid) {
+  std::lock_guard<std::mutex> lock(g_sequences_mutex);
+  if (!g_sequences) {
+    g_sequences = new FlowSequences();
+  }
+  return (written ? g_sequences->written : g_sequences->read)[writer_koid]++;
+}
+
+void ForgetSequences(zx_koid_t written_koid, zx_koid_t read_koid) {
+  std::lock_guard<std::mutex> lock(g_sequences_mutex);
+  if (g_sequences) {
+    g_sequences->written.erase(written_koid);
+    g_sequences->read.erase(read_koid);
+  }
+}
+
+void ResetSequences() {
+  std::lock_guard<std::mutex> lock(g_sequences_mutex);
+  if (g_sequences) {
+    g_sequences->written.clear();
+    g_sequences->read.clear();
+  }
+}
+
+// Both ends derive the flow of a message from the koid of the endpoint it
+// was written to, so that they agree. Two-way messages are told apart by
+// their txid, one-way messages, which all have txid 0, by their sequence
+// number on the channel.
+uint64_t FlowId(bool written, zx_koid_t writer_koid, uint32_t txid) {
+  const uint64_t base = static_cast<uint64_t>(writer_koid) << 32;
+  if (txid != 0) {
+    return base ^ txid;
+  }
+  return base ^ kOneWayFlow ^ NextSequence(written, writer_koid);
+}
+
+// FileTraceSink writes out its events in blocks of this size.
+constexpr size_t kFileBufferSize = 64 * 1024;
+
+double TicksToMicroseconds(zx_ticks_t ticks) {
+  static const double ticks_per_us = zx_ticks_per_second() / 1000000.0;
+  return ticks / ticks_per_us;
+}
+
+zx_koid_t ProcessKoid() {
+  static const zx_koid_t koid = GetKoid(zx_process_self(), false);
+  return koid;
+}
+
+zx_koid_t ThreadKoid() {
+  thread_local zx_koid_t koid = GetKoid(zx_thread_self(), false);
+  return koid;
+}
+
+}  // namespace
+
+TraceSink::~TraceSink() = default;
+
+void TraceSink::Flush() {}
+
+void SetTraceSink(std::shared_ptr<TraceSink> sink) {
+  std::shared_ptr<TraceSink> previous;
+  {
+    std::lock_guard<std::mutex> lock(g_sink_mutex);
+    if (!g_sink) {
+      g_sink = new std::shared_ptr<TraceSink>();
+    }
+    g_tracing.store(!!sink, std::memory_order_relaxed);
+    previous = std::move(*g_sink);
+    *g_sink = std::move(sink);
+    // A new trace numbers one-way messages from the start again.
+    ResetSequences();
+  }
+  // A native on another thread may still hold the previous sink, so its
+  // events so far are written out here rather than when it is destroyed.
+  if (previous) {
+    previous->Flush();
+  }
+}
+
+std::shared_ptr<TraceSink> GetTraceSink() {
+  if (!g_tracing.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(g_sink_mutex);
+  return g_sink ? *g_sink : nullptr;
+}
+
+void ForgetTraceSequences(zx_handle_t handle) {
+  if (!g_tracing.load(std::memory_order_relaxed)) {
+    return;
+  }
+  zx_info_handle_basic_t info;
+  zx_status_t status = zx_object_get_info(handle, ZX_INFO_HANDLE_BASIC, &info,
+                                          sizeof(info), nullptr, nullptr);
+  if (status != ZX_OK || info.type != ZX_OBJ_TYPE_CHANNEL) {
+    return;
+  }
+  // Messages written here are numbered by this endpoint's koid, and messages
+  // read here by the koid of the peer they were written to.
+  ForgetSequences(info.koid, info.related_koid);
+}
+
+std::shared_ptr<FileTraceSink> FileTraceSink::Create(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "w");
+  if (!file) {
+    return nullptr;
+  }
+  return std::shared_ptr<FileTraceSink>(new FileTraceSink(file));
+}
+
+FileTraceSink::FileTraceSink(FILE* file) : file_(file) {
+  setvbuf(file_, nullptr, _IOFBF, kFileBufferSize);
+  // The closing bracket is optional in the trace event format, which lets
+  // the events be appended as they happen.
+  fputs("[\n", file_);
+}
+
+FileTraceSink::~FileTraceSink() { fclose(file_); }
+
+void FileTraceSink::Duration(const char* name,
+                             zx_ticks_t start,
+                             zx_ticks_t end,
+                             uint64_t ordinal) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fprintf(file_,
+          "{\"cat\":\"zircon\",\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+          "\"dur\":%.3f,\"pid\":%" PRIu64 ",\"tid\":%" PRIu64
+          ",\"args\":{\"ordinal\":\"0x%" PRIx64 "\"}},\n",
+          name, TicksToMicroseconds(start), TicksToMicroseconds(end - start),
+          ProcessKoid(), ThreadKoid(), ordinal);
+}
+
+void FileTraceSink::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fflush(file_);
+}
+
+void FileTraceSink::FlowBegin(zx_ticks_t ticks,
+                              uint64_t flow_id,
+                              uint32_t txid,
+                              uint64_t ordinal) {
+  WriteFlow('s', ticks, flow_id, txid, ordinal);
+}
+
+void FileTraceSink::FlowEnd(zx_ticks_t ticks,
+                            uint64_t flow_id,
+                            uint32_t txid,
+                            uint64_t ordinal) {
+  WriteFlow('f', ticks, flow_id, txid, ordinal);
+}
+
+void FileTraceSink::WriteFlow(char phase,
+                              zx_ticks_t ticks,
+                              uint64_t flow_id,
+                              uint32_t txid,
+                              uint64_t ordinal) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fprintf(file_,
+          "{\"cat\":\"fidl\",\"name\":\"message\",\"ph\":\"%c\",\"bp\":\"e\","
+          "\"id\":\"0x%" PRIx64 "\",\"ts\":%.3f,\"pid\":%" PRIu64
+          ",\"tid\":%" PRIu64 ",\"args\":{\"txid\":%" PRIu32
+          ",\"ordinal\":\"0x%" PRIx64 "\"}},\n",
+          phase, flow_id, TicksToMicroseconds(ticks), ProcessKoid(),
+          ThreadKoid(), txid, ordinal);
+}
+
+TraceDuration::TraceDuration(const char* name)
+    : sink_(GetTraceSink()), name_(name) {
+  if (sink_) {
+    start_ = zx_ticks_get();
+  }
+}
+
+TraceDuration::~TraceDuration() {
+  if (sink_) {
+    sink_->Duration(name_, start_, zx_ticks_get(), ordinal_);
+  }
+}
+
+void TraceDuration::FlowBegin(zx_handle_t channel,
+                              const void* data,
+                              size_t size) {
+  if (sink_) {
+    FlowBeginAt(zx_ticks_get(), channel, data, size);
+  }
+}
+
+void TraceDuration::FlowBeginAt(zx_ticks_t ticks,
+                                zx_handle_t channel,
+                                const void* data,
+                                size_t size) {
+  uint32_t txid;
+  if (!ReadHeader(data, size, &txid)) {
+    return;
+  }
+  sink_->FlowBegin(ticks, FlowId(true, GetKoid(channel, false), txid), txid,
+                   ordinal_);
+}
+
+void TraceDuration::FlowEnd(zx_handle_t channel,
+                            const void* data,
+                            size_t size) {
+  uint32_t txid;
+  if (!ReadHeader(data, size, &txid)) {
+    return;
+  }
+  sink_->FlowEnd(zx_ticks_get(), FlowId(false, GetKoid(channel, true), txid),
+                 txid, ordinal_);
+}
+
+bool TraceDuration::ReadHeader(const void* data,
+                               size_t size,
+                               uint32_t* txid) {
+  if (!sink_ || size < kMessageHeaderSize) {
+    return false;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  memcpy(txid, bytes + kMessageTxidOffset, sizeof(*txid));
+  memcpy(&ordinal_, bytes + kMessageOrdinalOffset, sizeof(ordinal_));
+  return true;
+}
+
+}  // namespace dart
+}  // namespace zircon
@@ -0,0 +1,151 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DART_PKG_ZIRCON_SDK_EXT_TRACE_SINK_H_
+#define DART_PKG_ZIRCON_SDK_EXT_TRACE_SINK_H_
+
+#include <stdio.h>
+#include <zircon/types.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "src/lib/fxl/macros.h"
+
+namespace zircon {
+namespace dart {
+
+/**
+ * TraceSink receives the trace events of dart:zircon. Durations cover the
+ * natives that move FIDL messages and the waits for them. Flows connect the
+ * write of a message to its read at the other end of the channel, so that
+ * one request can be followed from encoding through the kernel and the wait
+ * to decoding. Two-way messages are keyed by their txid. One-way messages
+ * are numbered in the order they cross each channel, so their flows only
+ * pair up when both ends trace all of the channel's one-way messages.
+ *
+ * Times are in ticks. A sink may be called from any isolate's thread.
+ */
+class TraceSink {
+ public:
+  virtual ~TraceSink();
+
+  // A span called |name| from |start| to |end|. |ordinal| is the ordinal of
+  // the FIDL message involved, or zero.
+  virtual void Duration(const char* name,
+                        zx_ticks_t start,
+                        zx_ticks_t end,
+                        uint64_t ordinal) = 0;
+
+  // The start and the end of the flow |flow_id| of a message.
+  virtual void FlowBegin(zx_ticks_t ticks,
+                         uint64_t flow_id,
+                         uint32_t txid,
+                         uint64_t ordinal) = 0;
+  virtual void FlowEnd(zx_ticks_t ticks,
+                       uint64_t flow_id,
+                       uint32_t txid,
+                       uint64_t ordinal) = 0;
+
+  // Writes out any buffered events. Called when the sink is replaced.
+  virtual void Flush();
+};
+
+// Installs the process-wide sink, replacing the previous one. Null turns
+// tracing off, which is the default.
+void SetTraceSink(std::shared_ptr<TraceSink> sink);
+
+// Returns the current sink, or null when tracing is off. This is a single
+// relaxed load when tracing is off.
+std::shared_ptr<TraceSink> GetTraceSink();
+
+// Drops the one-way message numbering kept for |handle| if it is a channel,
+// as it is about to be closed or sent away. Does nothing when tracing is off.
+void ForgetTraceSequences(zx_handle_t handle);
+
+/**
+ * FileTraceSink appends events to a file in the Chrome trace event format,
+ * which chrome://tracing and Perfetto load directly. Events are buffered and
+ * written out when the buffer fills, on Flush() and when the sink is
+ * destroyed.
+ */
+class FileTraceSink : public TraceSink {
+ public:
+  // Returns null if |path| cannot be opened for writing.
+  static std::shared_ptr<FileTraceSink> Create(const std::string& path);
+
+  ~FileTraceSink() override;
+
+  void Duration(const char* name,
+                zx_ticks_t start,
+                zx_ticks_t end,
+                uint64_t ordinal) override;
+  void FlowBegin(zx_ticks_t ticks,
+                 uint64_t flow_id,
+                 uint32_t txid,
+                 uint64_t ordinal) override;
+  void FlowEnd(zx_ticks_t ticks,
+               uint64_t flow_id,
+               uint32_t txid,
+               uint64_t ordinal) override;
+  void Flush() override;
+
+ private:
+  explicit FileTraceSink(FILE* file);
+
+  void WriteFlow(char phase,
+                 zx_ticks_t ticks,
+                 uint64_t flow_id,
+                 uint32_t txid,
+                 uint64_t ordinal);
+
+  std::mutex mutex_;
+  FILE* const file_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FileTraceSink);
+};
+
+/**
+ * TraceDuration reports the span of its own lifetime to the current sink,
+ * if there is one. It keeps the sink alive until it reports.
+ */
+class TraceDuration {
+ public:
+  explicit TraceDuration(const char* name);
+  ~TraceDuration();
+
+  bool enabled() const { return !!sink_; }
+
+  // Starts or ends the flow of the message of |size| bytes at |data|, written
+  // to or read from |channel|. Messages shorter than a FIDL header are
+  // ignored.
+  void FlowBegin(zx_handle_t channel, const void* data, size_t size);
+  void FlowEnd(zx_handle_t channel, const void* data, size_t size);
+
+  // Like FlowBegin, for a message written at |ticks| whose header is only
+  // known later, such as a request sent by zx_channel_call, whose txid the
+  // kernel picks.
+  void FlowBeginAt(zx_ticks_t ticks,
+                   zx_handle_t channel,
+                   const void* data,
+                   size_t size);
+
+ private:
+  // Reads the txid and the ordinal of the message of |size| bytes at |data|
+  // into |txid| and ordinal_. Returns false if there is no sink or no header.
+  bool ReadHeader(const void* data, size_t size, uint32_t* txid);
+
+  std::shared_ptr<TraceSink> sink_;
+  const char* const name_;
+  zx_ticks_t start_ = 0;
+  uint64_t ordinal_ = 0;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(TraceDuration);
+};
+
+}  // namespace dart
+}  // namespace zircon
+
+#endif  // DART_PKG_ZIRCON_SDK_EXT_TRACE_SINK_H_
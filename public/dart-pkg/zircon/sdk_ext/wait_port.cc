@@ -0,0 +1,314 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "dart-pkg/zircon/sdk_ext/wait_port.h"
+
+#include <lib/async/default.h>
+#include <zircon/syscalls.h>
+
+#include <thread>
+#include <unordered_map>
+
+#include "dart-pkg/zircon/sdk_ext/isolate_state.h"
+#include "src/lib/fxl/logging.h"
+#include "third_party/dart/runtime/include/dart_api.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/logging/dart_error.h"
+
+using tonic::DartState;
+using tonic::ToDart;
+
+namespace zircon {
+namespace dart {
+namespace {
+
+// Number of packets the port thread reads before handing them over.
+constexpr size_t kMaxPacketsPerRead = 64;
+
+// Each completion is passed to Dart as a key, a status and observed signals.
+constexpr size_t kValuesPerCompletion = 3;
+
+// The key of the completion that reports a failure of the port itself,
+// outside the 32-bit range of the keys of waits. WaitPort.allWaits in Dart.
+constexpr uint64_t kAllWaitsKey = 1ull << 32;
+
+uint32_t PortId(uint64_t packet_key) {
+  return static_cast<uint32_t>(packet_key >> 32);
+}
+
+uint64_t PacketKey(uint32_t id, uint64_t key) {
+  return (static_cast<uint64_t>(id) << 32) | key;
+}
+
+// The port and thread that all WaitPorts share. It lives as long as the
+// process once the first WaitPort has been created.
+class SharedPort {
+ public:
+  static SharedPort* Get() {
+    static SharedPort* shared_port = new SharedPort();
+    return shared_port;
+  }
+
+  zx_handle_t port() const { return port_; }
+
+  // ZX_OK, or why the port stopped delivering packets. Once it has failed,
+  // no wait started on it will ever complete.
+  zx_status_t status() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return status_;
+  }
+
+  // Returns the id that |wait_port| is to put in its packet keys.
+  uint32_t Register(WaitPort* wait_port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t id;
+    do {
+      id = next_id_++;
+    } while (id == 0 || wait_ports_.count(id));
+    wait_ports_[id] = wait_port;
+    return id;
+  }
+
+  // Once this returns, the port thread no longer calls the WaitPort.
+  void Unregister(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wait_ports_.erase(id);
+  }
+
+ private:
+  SharedPort() {
+    status_ = zx_port_create(0, &port_);
+    if (status_ != ZX_OK) {
+      FXL_LOG(ERROR) << "WaitPort could not create its port: " << status_;
+      return;
+    }
+    std::thread([this] { ThreadMain(); }).detach();
+  }
+
+  void ThreadMain() {
+    zx_port_packet_t packets[kMaxPacketsPerRead];
+    for (;;) {
+      // Block for the first packet, then take whatever else is already
+      // queued.
+      zx_status_t status = zx_port_wait(port_, ZX_TIME_INFINITE, &packets[0]);
+      if (status != ZX_OK) {
+        // The pending waits can no longer complete, so end them all with the
+        // error rather than leave their owners waiting forever.
+        FXL_LOG(ERROR) << "WaitPort thread failed: " << status;
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_ = status;
+        for (auto& entry : wait_ports_) {
+          entry.second->Fail(status);
+        }
+        return;
+      }
+      size_t count = 1;
+      while (count < kMaxPacketsPerRead &&
+             zx_port_wait(port_, 0, &packets[count]) == ZX_OK) {
+        count++;
+      }
+
+      // Hand each run of packets for the same WaitPort over at once.
+      // Completions of waits whose WaitPort is gone are dropped.
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t start = 0;
+      while (start < count) {
+        const uint32_t id = PortId(packets[start].key);
+        size_t end = start + 1;
+        while (end < count && PortId(packets[end].key) == id) {
+          end++;
+        }
+        auto it = wait_ports_.find(id);
+        if (it != wait_ports_.end()) {
+          it->second->AddCompletions(&packets[start], end - start);
+        }
+        start = end;
+      }
+    }
+  }
+
+  zx_handle_t port_ = ZX_HANDLE_INVALID;
+  std::mutex mutex_;
+  zx_status_t status_ = ZX_OK;
+  std::unordered_map<uint32_t, WaitPort*> wait_ports_;
+  uint32_t next_id_ = 1;
+};
+
+}  // namespace
+
+IMPLEMENT_WRAPPERTYPEINFO(zircon, WaitPort);
+
+// clang-format: off
+
+#define FOR_EACH_STATIC_BINDING(V) V(WaitPort, Create)
+
+#define FOR_EACH_BINDING(V) \
+  V(WaitPort, Wait)         \
+  V(WaitPort, Cancel)       \
+  V(WaitPort, Close)
+
+// clang-format: on
+
+// Tonic is missing a comma.
+#define DART_REGISTER_NATIVE_STATIC_(CLASS, METHOD) \
+  DART_REGISTER_NATIVE_STATIC(CLASS, METHOD),
+
+FOR_EACH_STATIC_BINDING(DART_NATIVE_CALLBACK_STATIC)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void WaitPort::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({FOR_EACH_STATIC_BINDING(DART_REGISTER_NATIVE_STATIC_)
+                         FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fxl::RefPtr<WaitPort> WaitPort::Create() {
+  return fxl::MakeRefCounted<WaitPort>();
+}
+
+WaitPort::WaitPort()
+    : task_(this),
+      dispatcher_(async_get_default_dispatcher()),
+      dart_state_(DartState::Current()->GetWeakPtr()) {
+  // Without a dispatcher there is no way to deliver completions, so the port
+  // starts out closed.
+  if (dispatcher_) {
+    id_ = SharedPort::Get()->Register(this);
+  }
+}
+
+WaitPort::~WaitPort() { Close(); }
+
+zx_status_t WaitPort::Wait(fxl::RefPtr<Handle> handle,
+                           zx_signals_t signals,
+                           uint64_t key) {
+  if (!id_ || !handle || !handle->is_valid()) {
+    return ZX_ERR_BAD_STATE;
+  }
+  if (key > UINT32_MAX) {
+    return ZX_ERR_INVALID_ARGS;
+  }
+  zx_status_t status = SharedPort::Get()->status();
+  if (status != ZX_OK) {
+    return status;
+  }
+  return zx_object_wait_async(handle->handle(), SharedPort::Get()->port(),
+                              PacketKey(id_, key), signals,
+                              ZX_WAIT_ASYNC_ONCE);
+}
+
+zx_status_t WaitPort::Cancel(fxl::RefPtr<Handle> handle, uint64_t key) {
+  if (!id_ || !handle || !handle->is_valid()) {
+    return ZX_ERR_BAD_STATE;
+  }
+  if (key > UINT32_MAX) {
+    return ZX_ERR_INVALID_ARGS;
+  }
+  return zx_port_cancel(SharedPort::Get()->port(), handle->handle(),
+                        PacketKey(id_, key));
+}
+
+void WaitPort::Close() {
+  if (!id_) {
+    return;
+  }
+  // Waits that are still pending stay registered with the shared port until
+  // they complete or their handles are closed. Their packets no longer find
+  // this WaitPort and are dropped.
+  SharedPort::Get()->Unregister(id_);
+  id_ = 0;
+  task_.Cancel();
+  std::lock_guard<std::mutex> lock(mutex_);
+  completions_.clear();
+}
+
+void WaitPort::AddCompletions(const zx_port_packet_t* packets, size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const bool post_task = completions_.empty() && failure_ == ZX_OK;
+  completions_.insert(completions_.end(), packets, packets + count);
+  if (post_task) {
+    // The task is not pending here because it takes the completions before
+    // they can become non-empty again, and it is cancelled only after this
+    // WaitPort has been unregistered.
+    zx_status_t status = task_.Post(dispatcher_);
+    if (status != ZX_OK) {
+      // The dispatcher is shutting down.
+      completions_.clear();
+    }
+  }
+}
+
+void WaitPort::Fail(zx_status_t status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const bool post_task = completions_.empty() && failure_ == ZX_OK;
+  failure_ = status;
+  if (post_task && task_.Post(dispatcher_) != ZX_OK) {
+    // The dispatcher is shutting down.
+    completions_.clear();
+  }
+}
+
+void WaitPort::DeliverCompletions(async_dispatcher_t* dispatcher,
+                                  async::TaskBase* task,
+                                  zx_status_t status) {
+  std::vector<zx_port_packet_t> completions;
+  zx_status_t failure;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completions.swap(completions_);
+    failure = failure_;
+  }
+
+  auto state = dart_state_.lock();
+  if (status != ZX_OK || !state ||
+      (completions.empty() && failure == ZX_OK) || !dart_wrapper()) {
+    // Closed, or the isolate is gone.
+    return;
+  }
+  tonic::DartState::Scope scope(state);
+
+  Dart_Handle wrapper = Dart_HandleFromWeakPersistent(dart_wrapper());
+  if (Dart_IsNull(wrapper)) {
+    // The Dart object is being collected.
+    return;
+  }
+  Dart_Handle callback = Dart_GetField(wrapper, ToDart("_callback"));
+  if (tonic::LogIfError(callback) || Dart_IsNull(callback)) {
+    return;
+  }
+
+  const size_t count = completions.size() + (failure != ZX_OK ? 1 : 0);
+  size_t length = count * kValuesPerCompletion;
+  Dart_Handle list = Dart_NewTypedData(Dart_TypedData_kUint64, length);
+  FXL_DCHECK(!tonic::LogIfError(list));
+
+  Dart_TypedData_Type type;
+  void* data = nullptr;
+  intptr_t data_length = 0;
+  Dart_Handle result =
+      Dart_TypedDataAcquireData(list, &type, &data, &data_length);
+  FXL_DCHECK(!tonic::LogIfError(result));
+  uint64_t* values = static_cast<uint64_t*>(data);
+  for (const zx_port_packet_t& packet : completions) {
+    *values++ = packet.key & UINT32_MAX;
+    // Sign-extended so that negative statuses read back as negative ints.
+    *values++ = static_cast<int64_t>(packet.status);
+    *values++ = packet.signal.observed;
+  }
+  if (failure != ZX_OK) {
+    // Reported last, after the waits that did complete.
+    *values++ = kAllWaitsKey;
+    *values++ = static_cast<int64_t>(failure);
+    *values++ = 0;
+  }
+  Dart_TypedDataReleaseData(list);
+
+  IsolateState::Current()->ScheduleWaitCallback(
+      callback, list, ToDart(static_cast<int64_t>(count)));
+}
+
+}  // namespace dart
+}  // namespace zircon
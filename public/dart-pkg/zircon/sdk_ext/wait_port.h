@@ -0,0 +1,99 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DART_PKG_ZIRCON_SDK_EXT_WAIT_PORT_H_
+#define DART_PKG_ZIRCON_SDK_EXT_WAIT_PORT_H_
+
+#include <lib/async/cpp/task.h>
+#include <zircon/syscalls/port.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dart-pkg/zircon/sdk_ext/handle.h"
+#include "src/lib/fxl/memory/ref_counted.h"
+#include "third_party/tonic/dart_state.h"
+#include "third_party/tonic/dart_wrappable.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace zircon {
+namespace dart {
+
+/**
+ * WaitPort waits on many handles and delivers their completions in batches.
+ * Each wait is identified by a key chosen by the caller. All completions that
+ * arrive before the isolate gets to run are delivered to the callback in a
+ * single microtask, as a list of (key, status, observed) triples.
+ *
+ * All WaitPorts of the process share one port and one thread, which routes
+ * each packet to its WaitPort by the id in the upper half of the packet key,
+ * so keys are limited to 32 bits. The callback is a field of the Dart object
+ * rather than a persistent handle, so a WaitPort that Dart no longer refers
+ * to is collected and closed along with its waits.
+ */
+class WaitPort : public fxl::RefCountedThreadSafe<WaitPort>,
+                 public tonic::DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+  FRIEND_REF_COUNTED_THREAD_SAFE(WaitPort);
+  FRIEND_MAKE_REF_COUNTED(WaitPort);
+
+ public:
+  static fxl::RefPtr<WaitPort> Create();
+
+  // Starts a one-shot wait for |signals| on |handle|. Fails with
+  // ZX_ERR_BAD_STATE if the port is closed or the isolate has no dispatcher.
+  zx_status_t Wait(fxl::RefPtr<Handle> handle,
+                   zx_signals_t signals,
+                   uint64_t key);
+
+  // Cancels the wait on |handle| with |key| if it has not completed yet.
+  zx_status_t Cancel(fxl::RefPtr<Handle> handle, uint64_t key);
+
+  // Stops delivery. Completions of the pending waits are dropped and the
+  // callback is not called again.
+  void Close();
+
+  // Queues completions read from the shared port. Called on the port thread.
+  void AddCompletions(const zx_port_packet_t* packets, size_t count);
+
+  // Reports that the shared port failed with |status|, so none of the pending
+  // waits will complete. Called on the port thread.
+  void Fail(zx_status_t status);
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  WaitPort();
+  ~WaitPort();
+
+  void DeliverCompletions(async_dispatcher_t* dispatcher,
+                          async::TaskBase* task,
+                          zx_status_t status);
+
+  void RetainDartWrappableReference() const override { AddRef(); }
+
+  void ReleaseDartWrappableReference() const override { Release(); }
+
+  async::TaskMethod<WaitPort, &WaitPort::DeliverCompletions> task_;
+  async_dispatcher_t* const dispatcher_;
+  std::weak_ptr<tonic::DartState> dart_state_;
+  // The id of this port in the packet keys, or 0 once closed.
+  uint32_t id_ = 0;
+
+  // Completions read by the port thread that the isolate has not seen yet.
+  // A delivery task is posted only when this goes from empty to non-empty.
+  std::mutex mutex_;
+  std::vector<zx_port_packet_t> completions_;
+  // Set once the shared port has failed; delivered after |completions_|.
+  zx_status_t failure_ = ZX_OK;
+};
+
+}  // namespace dart
+}  // namespace zircon
+
+#endif  // DART_PKG_ZIRCON_SDK_EXT_WAIT_PORT_H_
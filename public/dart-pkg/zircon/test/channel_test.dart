@@ -73,6 +73,137 @@ void main() {
     expect(readResult.handles[0].isValid, isTrue);
   });
 
+  test('channel write segments', () {
+    final HandlePairResult pair = System.channelCreate();
+    final HandlePairResult eventPair = System.eventpairCreate();
+    final int status = System.channelWriteV(
+        pair.first,
+        <TypedData>[
+          utf8Bytes('Hello, '),
+          Uint8List.fromList(utf8.encode('world'))
+        ],
+        <Handle>[eventPair.first]);
+    expect(status, equals(ZX.OK));
+    expect(eventPair.first.isValid, isFalse);
+
+    final ReadResult readResult = System.channelRead(pair.second);
+    expect(readResult.status, equals(ZX.OK));
+    expect(readResult.bytesAsUTF8String(), equals('Hello, world'));
+    expect(readResult.handles.length, equals(1));
+
+    // Segments that do not fit in a single message are rejected.
+    expect(
+        System.channelWriteV(
+            pair.first,
+            <TypedData>[ByteData(ZX.CHANNEL_MAX_MSG_BYTES), ByteData(1)],
+            <Handle>[]),
+        equals(ZX.ERR_OUT_OF_RANGE));
+  });
+
+  test('channel read', () {
+    final HandlePairResult pair = System.channelCreate();
+
+    // When no data is available, ZX.ERR_SHOULD_WAIT is returned.
+    expect(System.channelRead(pair.second).status, equals(ZX.ERR_SHOULD_WAIT));
+
+    final HandlePairResult eventPair = System.eventpairCreate();
+    final ByteData data = utf8Bytes('Hello, world');
+    expect(System.channelWrite(pair.first, data, <Handle>[eventPair.first]),
+        equals(ZX.OK));
+
+    final ReadResult readResult = System.channelRead(pair.second);
+    expect(readResult.status, equals(ZX.OK));
+    expect(readResult.numBytes, equals(data.lengthInBytes));
+    expect(readResult.bytes.lengthInBytes, equals(data.lengthInBytes));
+    expect(readResult.bytesAsUTF8String(), equals('Hello, world'));
+    expect(readResult.handles.length, equals(1));
+    expect(readResult.handles[0].isValid, isTrue);
+  });
+
+  test('channel read into', () {
+    final HandlePairResult pair = System.channelCreate();
+    final ByteData target = ByteData(64);
+    final List<Handle> handles = List<Handle>(4);
+    expect(System.channelReadInto(pair.second, target, handles),
+        equals(ZX.ERR_SHOULD_WAIT));
+
+    final HandlePairResult eventPair = System.eventpairCreate();
+    final ByteData data = utf8Bytes('Hello, world');
+    expect(System.channelWrite(pair.first, data, <Handle>[eventPair.first]),
+        equals(ZX.OK));
+
+    // Too small a buffer leaves the message queued and reports its sizes.
+    expect(System.channelReadInto(pair.second, ByteData(4), handles),
+        equals(ZX.ERR_BUFFER_TOO_SMALL));
+    expect(System.lastNumBytes, equals(data.lengthInBytes));
+    expect(System.lastNumHandles, equals(1));
+
+    final int allocations = System.nativeAllocations;
+    expect(System.channelReadInto(pair.second, target, handles), equals(ZX.OK));
+    expect(System.lastNumBytes, equals(data.lengthInBytes));
+    expect(System.lastNumHandles, equals(1));
+    // Only the received Handle is allocated.
+    expect(System.nativeAllocations - allocations, equals(1));
+    expect(utf8.decode(target.buffer.asUint8List(0, System.lastNumBytes)),
+        equals('Hello, world'));
+    expect(handles[0].isValid, isTrue);
+    expect(handles[1], isNull);
+  });
+
+  test('channel read batch', () {
+    final HandlePairResult pair = System.channelCreate();
+
+    // When no data is available, ZX.ERR_SHOULD_WAIT is returned.
+    expect(System.channelReadBatch(pair.second, 4, 1024).status,
+        equals(ZX.ERR_SHOULD_WAIT));
+
+    final HandlePairResult eventPair = System.eventpairCreate();
+    expect(System.channelWrite(pair.first, utf8Bytes('one'), <Handle>[]),
+        equals(ZX.OK));
+    expect(
+        System.channelWrite(
+            pair.first, utf8Bytes('two'), <Handle>[eventPair.first]),
+        equals(ZX.OK));
+    expect(System.channelWrite(pair.first, utf8Bytes('three'), <Handle>[]),
+        equals(ZX.OK));
+
+    // The message limit leaves the third message queued.
+    final ReadBatchResult batch = System.channelReadBatch(pair.second, 2, 1024);
+    expect(batch.status, equals(ZX.OK));
+    expect(batch.numMessages, equals(2));
+    expect(batch.bytes.lengthInBytes, equals(6));
+    expect(batch.handles.length, equals(1));
+    expect(batch.messageAt(0).bytesAsUTF8String(), equals('one'));
+    expect(batch.messageAt(0).handles.length, equals(0));
+    expect(batch.messageAt(1).bytesAsUTF8String(), equals('two'));
+    expect(batch.messageAt(1).handles.length, equals(1));
+
+    // The byte budget is exceeded by the first message, which is still read.
+    final ReadBatchResult rest = System.channelReadBatch(pair.second, 4, 1);
+    expect(rest.status, equals(ZX.OK));
+    expect(rest.numMessages, equals(1));
+    expect(rest.messageAt(0).bytesAsUTF8String(), equals('three'));
+  });
+
+  test('channel read batch bounds its limits', () {
+    final HandlePairResult pair = System.channelCreate();
+    for (int i = 0; i < 65; i++) {
+      expect(System.channelWrite(pair.first, utf8Bytes('$i'), <Handle>[]),
+          equals(ZX.OK));
+    }
+
+    // At most 64 messages are read, however many are asked for.
+    final ReadBatchResult batch =
+        System.channelReadBatch(pair.second, 1 << 30, 0xffffffff);
+    expect(batch.status, equals(ZX.OK));
+    expect(batch.numMessages, equals(64));
+    expect(batch.messageAt(63).bytesAsUTF8String(), equals('63'));
+
+    final ReadBatchResult rest = System.channelReadBatch(pair.second, 4, 1024);
+    expect(rest.numMessages, equals(1));
+    expect(rest.messageAt(0).bytesAsUTF8String(), equals('64'));
+  });
+
   test('async wait channel read', () async {
     final HandlePairResult pair = System.channelCreate();
     final Completer<List<int>> completer = Completer<List<int>>();
@@ -104,4 +235,22 @@ void main() {
     final int status = await completer.future;
     expect(status, equals(ZX.OK));
   });
+  test('channel call times out', () {
+    final HandlePairResult pair = System.channelCreate();
+    expect(pair.status, equals(ZX.OK));
+
+    final ByteData request = ByteData(16);
+    final int deadline =
+        System.clockGet(ZX.CLOCK_MONOTONIC) + 10 * 1000 * 1000;
+    final ReadResult result =
+        System.channelCall(pair.first, request, <Handle>[], deadline);
+    expect(result.status, equals(ZX.ERR_TIMED_OUT));
+
+    // The request was delivered with a kernel assigned txid.
+    final ReadResult delivered = System.channelRead(pair.second);
+    expect(delivered.status, equals(ZX.OK));
+    expect(delivered.numBytes, equals(16));
+    expect(delivered.bytes.getUint32(0, Endian.little) & 0x80000000,
+        isNonZero);
+  });
 }
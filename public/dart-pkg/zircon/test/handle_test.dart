@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+import 'dart:async';
+import 'dart:typed_data';
+
 import 'package:test/test.dart';
 import 'package:zircon/zircon.dart';
 
@@ -24,4 +27,158 @@ void main() {
     final Handle duplicate = handle.duplicate(ZX.RIGHT_SAME_RIGHTS);
     expect(duplicate.isValid, isFalse);
   });
+  test('replace handle', () {
+    final HandlePairResult pair = System.eventpairCreate();
+    final Handle replaced = pair.first.replace(ZX.RIGHT_SAME_RIGHTS);
+    expect(replaced.isValid, isTrue);
+    expect(pair.first.isValid, isFalse);
+
+    final Handle failedReplace = replaced.replace(-1);
+    expect(failedReplace.isValid, isFalse);
+    expect(replaced.isValid, isFalse);
+    expect(Handle.invalid().replace(ZX.RIGHT_SAME_RIGHTS).isValid, isFalse);
+    pair.second.close();
+  });
+  test('close many handles', () async {
+    final HandlePairResult first = System.eventpairCreate();
+    final HandlePairResult second = System.eventpairCreate();
+    first.first.asyncWait(EventPair.PEER_CLOSED, (int status, int pending) {
+      fail('pending wait was not cancelled');
+    });
+
+    final List<Handle> handles = <Handle>[
+      first.first,
+      second.first,
+      Handle.invalid(),
+    ];
+    expect(System.handleCloseMany(handles), equals(ZX.OK));
+    for (Handle handle in handles) {
+      expect(handle.isValid, isFalse);
+    }
+
+    // The peers observe the close; the cancelled wait never completes.
+    final Completer<int> peerClosed = Completer<int>();
+    second.second.asyncWait(EventPair.PEER_CLOSED,
+        (int status, int pending) => peerClosed.complete(status));
+    expect(await peerClosed.future, equals(ZX.OK));
+    System.handleCloseMany(<Handle>[first.second, second.second]);
+  });
+  test('persistent wait', () async {
+    final ChannelPair pair = ChannelPair();
+    final StreamController<int> signals = StreamController<int>();
+    final HandleWaiter waiter = pair.second.handle.asyncWaitPersistent(
+        Channel.READABLE | Channel.PEER_CLOSED, (int status, int pending) {
+      expect(status, equals(ZX.OK));
+      if ((pending & Channel.READABLE) != 0) {
+        pair.second.queryAndRead();
+      }
+      signals.add(pending);
+    });
+    final StreamIterator<int> iterator = StreamIterator<int>(signals.stream);
+
+    for (int i = 0; i < 3; i++) {
+      pair.first.write(ByteData(1));
+      expect(await iterator.moveNext(), isTrue);
+      expect(iterator.current & Channel.READABLE, isNonZero);
+    }
+
+    // Peer-closed on its own ends the wait.
+    pair.first.close();
+    expect(await iterator.moveNext(), isTrue);
+    expect(iterator.current & Channel.PEER_CLOSED, isNonZero);
+    expect(iterator.current & Channel.READABLE, isZero);
+    waiter.cancel();
+    pair.second.close();
+    await signals.close();
+  });
+  test('wait completions run in order', () async {
+    final List<EventPairPair> pairs =
+        List<EventPairPair>.generate(4, (_) => EventPairPair());
+    final List<int> completed = <int>[];
+    final Completer<void> done = Completer<void>();
+    for (int i = 0; i < pairs.length; i++) {
+      pairs[i].second.handle.asyncWait(EventPair.PEER_CLOSED,
+          (int status, int pending) {
+        expect(status, equals(ZX.OK));
+        completed.add(i);
+        if (completed.length == pairs.length) {
+          done.complete();
+        }
+      });
+    }
+    for (EventPairPair pair in pairs) {
+      pair.first.close();
+    }
+    await done.future;
+    expect(completed, equals(<int>[0, 1, 2, 3]));
+    for (EventPairPair pair in pairs) {
+      pair.second.close();
+    }
+  });
+  test('persistent wait outlives a throwing callback', () async {
+    final ChannelPair pair = ChannelPair();
+    final StreamController<int> reads = StreamController<int>();
+    final List<Object> errors = <Object>[];
+    HandleWaiter waiter;
+    runZoned(() {
+      waiter = pair.second.handle.asyncWaitPersistent(Channel.READABLE,
+          (int status, int pending) {
+        final int value = pair.second.queryAndRead().bytes.getUint8(0);
+        reads.add(value);
+        if (value == 0) {
+          throw StateError('callback failed');
+        }
+      });
+    }, onError: (Object error, StackTrace stackTrace) => errors.add(error));
+    final StreamIterator<int> iterator = StreamIterator<int>(reads.stream);
+
+    for (int i = 0; i < 2; i++) {
+      pair.first.write(ByteData(1)..setUint8(0, i));
+      expect(await iterator.moveNext(), isTrue);
+      expect(iterator.current, equals(i));
+    }
+    expect(errors, hasLength(1));
+    expect(errors.single, isStateError);
+    waiter.cancel();
+    pair.first.close();
+    pair.second.close();
+    await reads.close();
+  });
+  test('wait completions that arrive together run before their microtasks',
+      () async {
+    final List<EventPairPair> pairs =
+        List<EventPairPair>.generate(2, (_) => EventPairPair());
+    final List<String> events = <String>[];
+    final Completer<void> done = Completer<void>();
+    // Both peers are closed before either wait starts, so the completions are
+    // queued together and their callbacks run in one microtask, ahead of the
+    // microtasks they schedule.
+    for (EventPairPair pair in pairs) {
+      pair.first.close();
+    }
+    for (int i = 0; i < pairs.length; i++) {
+      pairs[i].second.handle.asyncWait(EventPair.PEER_CLOSED,
+          (int status, int pending) {
+        events.add('callback $i');
+        scheduleMicrotask(() {
+          events.add('microtask $i');
+          if (i == pairs.length - 1) {
+            done.complete();
+          }
+        });
+      });
+    }
+    await done.future;
+    expect(
+        events,
+        equals(<String>[
+          'callback 0',
+          'callback 1',
+          'microtask 0',
+          'microtask 1',
+        ]));
+    for (EventPairPair pair in pairs) {
+      pair.second.close();
+    }
+  });
 }
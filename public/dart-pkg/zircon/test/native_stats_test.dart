@@ -0,0 +1,70 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:test/test.dart';
+import 'package:zircon/zircon.dart';
+
+NativeCallStats statsOf(String name) =>
+    NativeStats.snapshot().firstWhere((NativeCallStats s) => s.name == name);
+
+void main() {
+  setUp(NativeStats.enable);
+  tearDown(NativeStats.disable);
+
+  test('channel calls are counted', () {
+    final ChannelPair pair = ChannelPair();
+    final EventPairPair event = EventPairPair();
+    final NativeCallStats writeBefore = statsOf('Channel.write');
+    final NativeCallStats readBefore = statsOf('Channel.read');
+
+    pair.first.write(ByteData(16), <Handle>[event.first.handle]);
+    final ReadResult result = pair.second.queryAndRead();
+    expect(result.status, equals(ZX.OK));
+
+    final NativeCallStats write = statsOf('Channel.write');
+    expect(write.calls - writeBefore.calls, equals(1));
+    expect(write.errors - writeBefore.errors, equals(0));
+    expect(write.bytes - writeBefore.bytes, equals(16));
+    expect(write.handles - writeBefore.handles, equals(1));
+    final NativeCallStats read = statsOf('Channel.read');
+    expect(read.calls - readBefore.calls, equals(1));
+    expect(read.bytes - readBefore.bytes, equals(16));
+    expect(read.handles - readBefore.handles, equals(1));
+    expect(read.latencyHistogram.reduce((int a, int b) => a + b),
+        equals(read.calls));
+
+    result.handles.first.close();
+    event.second.close();
+    pair.first.close();
+    pair.second.close();
+  });
+
+  test('errors are counted', () {
+    final NativeCallStats before = statsOf('Handle.close');
+    Handle.invalid().close();
+    final NativeCallStats after = statsOf('Handle.close');
+    expect(after.calls - before.calls, equals(1));
+    expect(after.errors - before.errors, equals(1));
+  });
+
+  test('reads with nothing to read are not errors', () {
+    final ChannelPair pair = ChannelPair();
+    final NativeCallStats before = statsOf('Channel.read');
+    expect(pair.second.queryAndRead().status, equals(ZX.ERR_SHOULD_WAIT));
+    final NativeCallStats after = statsOf('Channel.read');
+    expect(after.calls - before.calls, equals(1));
+    expect(after.errors - before.errors, equals(0));
+    pair.first.close();
+    pair.second.close();
+  });
+
+  test('nothing is counted while disabled', () {
+    NativeStats.disable();
+    final NativeCallStats before = statsOf('Handle.close');
+    Handle.invalid().close();
+    expect(statsOf('Handle.close').calls, equals(before.calls));
+  });
+}
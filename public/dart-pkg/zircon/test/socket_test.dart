@@ -39,6 +39,40 @@ void main() {
     expect(secondResult.status, equals(ZX.ERR_PEER_CLOSED));
   });
 
+  test('raw write socket', () {
+    final HandlePairResult pair = System.socketCreate();
+    final ByteData data = utf8Bytes('Hello, world');
+    expect(System.socketWriteRaw(pair.first, data, 0), equals(ZX.OK));
+    expect(System.lastNumBytes, equals(data.lengthInBytes));
+
+    final ReadResult readResult =
+        System.socketRead(pair.second, data.lengthInBytes);
+    expect(readResult.bytesAsUTF8String(), equals('Hello, world'));
+
+    pair.second.close();
+    expect(System.socketWriteRaw(pair.first, data, 0),
+        equals(ZX.ERR_PEER_CLOSED));
+    expect(System.lastNumBytes, equals(0));
+  });
+
+  test('read socket into buffer', () {
+    final HandlePairResult pair = System.socketCreate();
+    final ByteData target = ByteData(16);
+
+    // When no data is available, ZX.ERR_SHOULD_WAIT is returned.
+    expect(System.socketReadInto(pair.second, target, 0, 16),
+        equals(ZX.ERR_SHOULD_WAIT));
+
+    System.socketWrite(pair.first, utf8Bytes('Hello'), 0);
+    expect(System.socketReadInto(pair.second, target, 4, 12), equals(ZX.OK));
+    expect(System.lastNumBytes, equals(5));
+    expect(utf8.decode(target.buffer.asUint8List(4, 5)), equals('Hello'));
+
+    // The target range must fit in the buffer.
+    expect(System.socketReadInto(pair.second, target, 8, 12),
+        equals(ZX.ERR_OUT_OF_RANGE));
+  });
+
   test('read write socket', () {
     final HandlePairResult pair = System.socketCreate();
     expect(pair.status, equals(ZX.OK));
@@ -0,0 +1,80 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:test/test.dart';
+import 'package:zircon/zircon.dart';
+
+// Reads the events back. The format leaves the trailing comma and the
+// closing bracket out.
+List<Map<String, dynamic>> readEvents(String path) {
+  final String contents = File(path).readAsStringSync().trimRight();
+  final String json = contents.endsWith(',')
+      ? '${contents.substring(0, contents.length - 1)}]'
+      : '$contents]';
+  return List<Map<String, dynamic>>.from(jsonDecode(json));
+}
+
+void main() {
+  test('channel messages are traced with flows', () {
+    const String path = 'tmp/tracedata';
+    expect(System.setTraceFile(path), equals(ZX.OK));
+
+    final ChannelPair pair = ChannelPair();
+    final ByteData message = ByteData(16)
+      ..setUint32(0, 42, Endian.little)
+      ..setUint64(8, 0x1234, Endian.little);
+    pair.first.write(message);
+    expect(pair.second.queryAndRead().status, equals(ZX.OK));
+    expect(System.setTraceFile(''), equals(ZX.OK));
+    pair.first.close();
+    pair.second.close();
+
+    final List<Map<String, dynamic>> events = readEvents(path);
+    final Iterable<String> names =
+        events.where((e) => e['ph'] == 'X').map((e) => e['name']);
+    expect(names, containsAll(<String>['Channel.write', 'Channel.read']));
+
+    final Map<String, dynamic> begin = events.firstWhere((e) => e['ph'] == 's');
+    final Map<String, dynamic> end = events.firstWhere((e) => e['ph'] == 'f');
+    expect(begin['id'], equals(end['id']));
+    expect(begin['args']['txid'], equals(42));
+    expect(end['args']['ordinal'], equals('0x1234'));
+  });
+
+  test('one-way messages with the same ordinal get their own flows', () {
+    const String path = 'tmp/tracedata_one_way';
+    expect(System.setTraceFile(path), equals(ZX.OK));
+
+    final ChannelPair pair = ChannelPair();
+    final ByteData message = ByteData(16)..setUint64(8, 0x1234, Endian.little);
+    pair.first..write(message)..write(message);
+    final ReadBatchResult result =
+        System.channelReadBatch(pair.second.handle, 2, 1024);
+    expect(result.status, equals(ZX.OK));
+    expect(System.setTraceFile(''), equals(ZX.OK));
+    pair.first.close();
+    pair.second.close();
+
+    final List<Map<String, dynamic>> events = readEvents(path);
+    expect(events.where((e) => e['ph'] == 'X').map((e) => e['name']),
+        contains('Channel.readBatch'));
+    List<String> flowIds(String phase) => events
+        .where((e) => e['ph'] == phase)
+        .map<String>((e) => e['id'])
+        .toList();
+    final List<String> begins = flowIds('s');
+    final List<String> ends = flowIds('f');
+    expect(begins, hasLength(2));
+    expect(begins[0], isNot(equals(begins[1])));
+    expect(ends, equals(begins));
+  });
+
+  test('nothing is traced once tracing stops', () {
+    expect(System.traceBegin(), isZero);
+  });
+}
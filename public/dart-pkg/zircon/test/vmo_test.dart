@@ -25,6 +25,95 @@ void main() {
       expect(fileString, equals(fuchsia));
     });
 
+    test('mapFile', () {
+      const String fuchsia = 'Fuchsia';
+      File('tmp/mapfiledata')
+        ..createSync()
+        ..writeAsStringSync(fuchsia);
+
+      expect(utf8.decode(Vmo.mapFile('tmp/mapfiledata')), equals(fuchsia));
+      expect(utf8.decode(Vmo.mapFile('tmp/mapfiledata', offset: 2)),
+          equals('chsia'));
+      final Uint8List exact =
+          Vmo.mapFile('tmp/mapfiledata', offset: 1, length: 3, exact: true);
+      expect(utf8.decode(exact), equals('uch'));
+      expect(() => exact[0] = 0, throwsUnsupportedError);
+
+      expect(() => Vmo.mapFile('tmp/mapfiledata', offset: 8),
+          throwsA(const TypeMatcher<ZxStatusException>()));
+    });
+
+    test('mapRange', () {
+      final Vmo vmo = Vmo(System.vmoCreate(3 * 4096).handle);
+      final Uint8List mapped =
+          vmo.mapRange(offset: 4096 + 8, length: 16, writable: true);
+      expect(mapped.length, equals(16));
+      mapped.setAll(0, utf8.encode('Fuchsia'));
+
+      // Stores into the mapping are visible through the VMO.
+      final ReadResult readResult = vmo.read(7, 4096 + 8);
+      expect(readResult.status, equals(ZX.OK));
+      expect(readResult.bytesAsUTF8String(), equals('Fuchsia'));
+
+      // Read-only mappings reject stores.
+      final Uint8List readOnly = vmo.mapRange(offset: 4096 + 8, length: 7);
+      expect(utf8.decode(readOnly), equals('Fuchsia'));
+      expect(() => readOnly[0] = 0, throwsUnsupportedError);
+
+      expect(() => vmo.mapRange(offset: 3 * 4096, length: 1),
+          throwsA(const TypeMatcher<ZxStatusException>()));
+    });
+
+    test('mapRegion', () {
+      final Vmo vmo = Vmo(System.vmoCreate(2 * 4096).handle);
+      final VmoMapping mapping = vmo.mapRegion(
+          offset: 4096, length: 7, writable: true, prefault: true);
+      expect(mapping.isMapped, isTrue);
+      expect(mapping.data.length, equals(7));
+      mapping.data.setAll(0, utf8.encode('Fuchsia'));
+      expect(vmo.read(7, 4096).bytesAsUTF8String(), equals('Fuchsia'));
+
+      final Uint8List retained = mapping.data;
+      mapping.unmap();
+      expect(mapping.isMapped, isFalse);
+      expect(() => mapping.data, throwsStateError);
+      // Unmapping twice is a no-op.
+      mapping.unmap();
+
+      // A view kept past unmap no longer reflects the Vmo: it reads as zeros.
+      // Writing to it would fault.
+      expect(retained, everyElement(equals(0)));
+      expect(vmo.read(7, 4096).bytesAsUTF8String(), equals('Fuchsia'));
+    });
+
+    test('readInto', () {
+      const String fuchsia = 'Fuchsia';
+      final SizedVmo vmo =
+          SizedVmo.fromUint8List(Uint8List.fromList(fuchsia.codeUnits));
+      final ByteData target = ByteData(10);
+      expect(vmo.readInto(target, 3, 4, 3), equals(ZX.OK));
+      expect(utf8.decode(target.buffer.asUint8List(3, 4)), equals('hsia'));
+      expect(vmo.readInto(target, 8, 4), equals(ZX.ERR_OUT_OF_RANGE));
+    });
+
+    test('getSizeRaw', () {
+      final HandleResult vmo = System.vmoCreate(4096);
+      expect(vmo.status, equals(ZX.OK));
+      expect(System.vmoGetSizeRaw(vmo.handle), equals(ZX.OK));
+      expect(System.lastSize, equals(4096));
+      expect(System.vmoGetSizeRaw(Handle.invalid()),
+          equals(ZX.ERR_BAD_HANDLE));
+    });
+
+    test('raw results have their own slots', () {
+      final HandleResult vmo = System.vmoCreate(4096);
+      final HandlePairResult pair = System.socketCreate();
+      expect(System.vmoGetSizeRaw(vmo.handle), equals(ZX.OK));
+      expect(System.socketWriteRaw(pair.first, ByteData(3), 0), equals(ZX.OK));
+      expect(System.lastSize, equals(4096));
+      expect(System.lastNumBytes, equals(3));
+    });
+
     test('duplicate', () {
       const String fuchsia = 'Fuchsia';
       Uint8List data = Uint8List.fromList(fuchsia.codeUnits);
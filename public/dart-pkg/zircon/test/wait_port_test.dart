@@ -0,0 +1,116 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:test/test.dart';
+import 'package:zircon/zircon.dart';
+
+void main() {
+  test('wait port delivers keyed completions', () async {
+    final List<int> keys = <int>[];
+    final Completer<void> done = Completer<void>();
+    final WaitPort port = WaitPort((Uint64List completions, int count) {
+      for (int i = 0; i < count; i++) {
+        keys.add(completions[3 * i]);
+        expect(completions[3 * i + 1], equals(ZX.OK));
+        expect(completions[3 * i + 2] & Channel.READABLE, isNonZero);
+      }
+      if (keys.length == 3) {
+        done.complete();
+      }
+    });
+
+    final List<ChannelPair> pairs =
+        List<ChannelPair>.generate(3, (_) => ChannelPair());
+    for (int i = 0; i < pairs.length; i++) {
+      expect(port.wait(pairs[i].second.handle, Channel.READABLE, i + 10),
+          equals(ZX.OK));
+    }
+    for (ChannelPair pair in pairs) {
+      pair.first.write(ByteData(1));
+    }
+
+    await done.future;
+    expect(keys..sort(), equals(<int>[10, 11, 12]));
+    port.close();
+  });
+
+  test('wait port keys are 32 bits', () {
+    final WaitPort port = WaitPort((Uint64List completions, int count) {});
+    final ChannelPair pair = ChannelPair();
+    expect(port.wait(pair.second.handle, Channel.READABLE, 1 << 32),
+        equals(ZX.ERR_INVALID_ARGS));
+    port.close();
+    expect(port.wait(pair.second.handle, Channel.READABLE, 0),
+        equals(ZX.ERR_BAD_STATE));
+    pair.first.close();
+    pair.second.close();
+  });
+
+  test('wait set runs callbacks', () async {
+    final WaitSet waitSet = WaitSet();
+    final ChannelPair pair = ChannelPair();
+    final EventPairPair eventPair = EventPairPair();
+    final Completer<int> completer = Completer<int>();
+
+    waitSet.asyncWait(pair.second.handle, Channel.READABLE,
+        (int status, int pending) => completer.complete(status));
+    final WaitSetWaiter cancelled = waitSet.asyncWait(
+        eventPair.second.handle,
+        EventPair.PEER_CLOSED,
+        (int status, int pending) => fail('cancelled wait completed'));
+    expect(waitSet.length, equals(2));
+
+    cancelled.cancel();
+    expect(cancelled.isPending, isFalse);
+    eventPair.first.close();
+    pair.first.write(ByteData(1));
+
+    expect(await completer.future, equals(ZX.OK));
+    expect(waitSet.length, equals(0));
+    waitSet.close();
+  });
+
+  test('wait set keeps delivering after a callback throws', () async {
+    final WaitSet waitSet = WaitSet();
+    final List<ChannelPair> pairs =
+        List<ChannelPair>.generate(2, (_) => ChannelPair());
+    final Completer<Object> error = Completer<Object>();
+    final Completer<int> delivered = Completer<int>();
+
+    runZoned(() {
+      waitSet
+        ..asyncWait(pairs[0].second.handle, Channel.READABLE,
+            (int status, int pending) => throw StateError('callback failed'))
+        ..asyncWait(pairs[1].second.handle, Channel.READABLE,
+            (int status, int pending) => delivered.complete(status));
+    }, onError: error.complete);
+    for (ChannelPair pair in pairs) {
+      pair.first.write(ByteData(1));
+    }
+
+    expect(await error.future, isStateError);
+    expect(await delivered.future, equals(ZX.OK));
+    expect(waitSet.length, equals(0));
+    waitSet.close();
+  });
+
+  test('wait set drops waits on closed handles', () {
+    final WaitSet waitSet = WaitSet();
+    final List<ChannelPair> pairs =
+        List<ChannelPair>.generate(3, (_) => ChannelPair());
+    for (ChannelPair pair in pairs) {
+      waitSet.asyncWait(pair.second.handle, Channel.READABLE,
+          (int status, int pending) => fail('closed wait completed'));
+    }
+    expect(waitSet.length, equals(3));
+
+    pairs[0].second.close();
+    pairs[1].second.close();
+    expect(waitSet.length, equals(1));
+    waitSet.close();
+  });
+}
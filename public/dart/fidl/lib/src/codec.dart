@@ -30,21 +30,90 @@ void _throwIfNegative(int value) {
 
 const int _kInitialBufferSize = 1024;
 
+// Encoders take their buffers from a pool, and the messages they produce
+// give them back once they have been written to a channel, so that sending
+// a message neither allocates nor zeroes a buffer. Like every global, the
+// pool is per isolate.
+const int _kMaxPooledBuffers = 8;
+// ZX_CHANNEL_MAX_MSG_BYTES, the most a message can hold.
+const int _kMaxPooledBufferSize = 65536;
+final List<ByteData> _bufferPool = <ByteData>[];
+
+// Takes the smallest pooled buffer that holds [size] bytes, so that small
+// messages leave the large buffers to the messages that need them.
+ByteData _takeBuffer(int size) {
+  int best = -1;
+  for (int i = 0; i < _bufferPool.length; i++) {
+    final int length = _bufferPool[i].lengthInBytes;
+    if (length >= size &&
+        (best < 0 || length < _bufferPool[best].lengthInBytes)) {
+      best = i;
+    }
+  }
+  if (best < 0) {
+    return ByteData(size < _kInitialBufferSize ? _kInitialBufferSize : size);
+  }
+  final ByteData buffer = _bufferPool[best];
+  _bufferPool[best] = _bufferPool.last;
+  _bufferPool.removeLast();
+  return buffer;
+}
+
+// Gives back [buffer], of which the first [extent] bytes were used. They are
+// zeroed, as encoding relies on fresh memory being zero.
+void _returnBuffer(ByteData buffer, int extent) {
+  if (buffer.lengthInBytes > _kMaxPooledBufferSize ||
+      _bufferPool.length >= _kMaxPooledBuffers ||
+      _bufferPool.any((ByteData pooled) => identical(pooled, buffer))) {
+    return;
+  }
+  buffer.buffer.asUint8List(0, extent).fillRange(0, extent, 0);
+  _bufferPool.add(buffer);
+}
+
+class _EncodedMessage extends Message {
+  _EncodedMessage(ByteData data, List<Handle> handles, this._buffer)
+      : super(data, handles);
+
+  ByteData _buffer;
+
+  @override
+  void release() {
+    if (_buffer != null) {
+      _returnBuffer(_buffer, data.lengthInBytes);
+      _buffer = null;
+    }
+  }
+}
+
 class Encoder {
-  Encoder();
+  /// Creates an encoder whose buffer holds at least [sizeHint] bytes before
+  /// it has to grow. Generated bindings pass the most a message can encode
+  /// to, or the default size when that is unbounded.
+  Encoder([int sizeHint = _kInitialBufferSize])
+      : data = _takeBuffer(sizeHint);
 
   Message get message {
     final ByteData trimmed = ByteData.view(data.buffer, 0, _extent);
-    return Message(trimmed, _handles);
+    if (_traceStart != 0) {
+      System.traceEnd(System.TRACE_FIDL_ENCODE, _traceStart, _traceOrdinal);
+      _traceStart = 0;
+    }
+    return _EncodedMessage(trimmed, _handles, data);
   }
 
-  ByteData data = ByteData(_kInitialBufferSize);
+  ByteData data;
   final List<Handle> _handles = <Handle>[];
   int _extent = 0;
 
+  // Encoding is traced from the header to [message].
+  int _traceStart = 0;
+  int _traceOrdinal = 0;
+
   void _grow(int newSize) {
     final Uint8List newList = Uint8List(newSize)
       ..setRange(0, data.lengthInBytes, data.buffer.asUint8List());
+    _returnBuffer(data, data.lengthInBytes);
     data = newList.buffer.asByteData();
   }
 
@@ -76,6 +145,8 @@ class Encoder {
   }
 
   void encodeMessageHeader(int ordinal, int txid) {
+    _traceStart = System.traceBegin();
+    _traceOrdinal = ordinal;
     alloc(kMessageHeaderSize);
     encodeUint32(txid, kMessageTxidOffset);
     encodeUint8(_kUnionAsXUnionFlag, kMessageFlagOffset);
@@ -304,7 +304,11 @@ abstract class Binding<T> {
       close();
       throw FidlError('Incompatible wire format', FidlErrorCode.fidlUnknownMagic);
     }
+    final int traceStart = System.traceBegin();
     handleMessage(message, sendMessage);
+    if (traceStart != 0) {
+      System.traceEnd(System.TRACE_FIDL_DECODE, traceStart, message.ordinal);
+    }
   }
 
   /// Always called when the channel underneath closes. If [onConnectionError]
@@ -325,6 +329,7 @@ abstract class Binding<T> {
       return;
     }
     _reader.channel.write(response.data, response.handles);
+    response.release();
   }
 
   final ChannelReader _reader = ChannelReader();
@@ -488,6 +493,19 @@ class ProxyController<T> {
   /// Used by subclasses of [Proxy<T>] to receive responses to messages.
   MessageSink onResponse;
 
+  /// When set, requests that expect a response are sent with
+  /// [Channel.callSync], which blocks until the reply arrives or
+  /// [callTimeout] passes. The reply is passed to [onResponse] before
+  /// [sendMessageWithResponse] returns, without a trip through the event
+  /// loop. A call that fails or times out throws a [FidlError] from
+  /// [sendMessageWithResponse] instead of calling its callback. Meant for
+  /// worker isolates that make back-to-back calls.
+  bool synchronousCalls = false;
+
+  /// How long a synchronous call may wait for its reply, or `null` to wait
+  /// forever.
+  Duration callTimeout;
+
   final ChannelReader _reader = ChannelReader();
   final HashMap<int, Function> _callbackMap = HashMap<int, Function>();
 
@@ -519,16 +537,24 @@ class ProxyController<T> {
       proxyError('Read from channel ${_reader.channel} failed');
       return;
     }
+    _handleResponse(result);
+  }
+
+  void _handleResponse(ReadResult result) {
     try {
       _pendingResponsesCount--;
       if (onResponse != null) {
-        onResponse(Message.fromReadResult(result));
+        final Message message = Message.fromReadResult(result);
+        final int traceStart = System.traceBegin();
+        onResponse(message);
+        if (traceStart != 0) {
+          System.traceEnd(
+              System.TRACE_FIDL_DECODE, traceStart, message.ordinal);
+        }
       }
     } on FidlError catch (e) {
-      if (result.handles != null) {
-        for (Handle handle in result.handles) {
-          handle.close();
-        }
+      if (result.handles != null && result.handles.isNotEmpty) {
+        System.handleCloseMany(result.handles);
       }
       proxyError(e.toString());
       close();
@@ -554,6 +580,7 @@ class ProxyController<T> {
       return;
     }
     final int status = _reader.channel.write(message.data, message.handles);
+    message.release();
     if (status != ZX.OK)
       proxyError(
           'Failed to write to channel: ${_reader.channel} (status: $status)');
@@ -569,6 +596,11 @@ class ProxyController<T> {
       return;
     }
 
+    if (synchronousCalls) {
+      _sendMessageWithResponseSync(message, callback);
+      return;
+    }
+
     const int _kUserspaceTxidMask = 0x7FFFFFFF;
 
     int txid = _nextTxid++ & _kUserspaceTxidMask;
@@ -576,6 +608,7 @@ class ProxyController<T> {
       txid = _nextTxid++ & _kUserspaceTxidMask;
     message.txid = txid;
     final int status = _reader.channel.write(message.data, message.handles);
+    message.release();
 
     if (status != ZX.OK) {
       proxyError(
@@ -583,8 +616,27 @@ class ProxyController<T> {
       return;
     }
 
-    _callbackMap[message.txid] = callback;
+    _callbackMap[txid] = callback;
+    _pendingResponsesCount++;
+  }
+
+  void _sendMessageWithResponseSync(Message message, Function callback) {
+    // The kernel picks the txid, from a range userspace txids never use.
+    final ReadResult result = _reader.channel.callSync(message.data,
+        handles: message.handles, timeout: callTimeout);
+    message.release();
+    if (result.status != ZX.OK) {
+      final String error =
+          'Failed to call on channel: ${_reader.channel} (status: ${result.status})';
+      proxyError(error);
+      // The callback has no way to receive an error, and the caller is still
+      // waiting on this call.
+      throw FidlError(error);
+    }
+
+    _callbackMap[Message.fromReadResult(result).txid] = callback;
     _pendingResponsesCount++;
+    _handleResponse(result);
   }
 
   /// Returns the callback associated with the given response message.
@@ -245,7 +245,11 @@ abstract class AsyncBinding<T> extends _Stateful {
       close();
       throw FidlError('Incompatible wire format', FidlErrorCode.fidlUnknownMagic);
     }
+    final int traceStart = System.traceBegin();
     handleMessage(message, sendMessage);
+    if (traceStart != 0) {
+      System.traceEnd(System.TRACE_FIDL_DECODE, traceStart, message.ordinal);
+    }
   }
 
   /// Always called when the channel underneath closes.
@@ -264,6 +268,7 @@ abstract class AsyncBinding<T> extends _Stateful {
       return;
     }
     _reader.channel.write(response.data, response.handles);
+    response.release();
   }
 
   final ChannelReader _reader = ChannelReader();
@@ -312,6 +317,17 @@ class AsyncProxyController<T> extends _Stateful {
   final HashMap<int, Completer<dynamic>> _completerMap = HashMap();
   int _nextTxid = 1;
 
+  /// When set, requests that expect a response are sent with
+  /// [Channel.callSync], which blocks until the reply arrives or
+  /// [callTimeout] passes. The completer is completed, with an error if the
+  /// call fails or times out, before [sendMessageWithResponse] returns,
+  /// without a trip through the event loop. Meant for worker isolates that make back-to-back calls.
+  bool synchronousCalls = false;
+
+  /// How long a synchronous call may wait for its reply, or `null` to wait
+  /// forever.
+  Duration callTimeout;
+
   /// Creates proxy controller.
   ///
   /// Proxy controllers are not typically created directly. Instead, you
@@ -459,6 +475,10 @@ class AsyncProxyController<T> extends _Stateful {
           'AsyncProxyController<${$interfaceName}>: Read from channel failed'));
       return;
     }
+    _handleMessage(result);
+  }
+
+  void _handleMessage(ReadResult result) {
     try {
       Message message = Message.fromReadResult(result);
       if (message.ordinal == epitaphOrdinal) {
@@ -467,13 +487,16 @@ class AsyncProxyController<T> extends _Stateful {
           onEpitaphReceived(statusCode);
         }
       } else if (onResponse != null) {
+        final int traceStart = System.traceBegin();
         onResponse(message);
+        if (traceStart != 0) {
+          System.traceEnd(
+              System.TRACE_FIDL_DECODE, traceStart, message.ordinal);
+        }
       }
     } on FidlError catch (e) {
-      if (result.handles != null) {
-        for (Handle handle in result.handles) {
-          handle.close();
-        }
+      if (result.handles != null && result.handles.isNotEmpty) {
+        System.handleCloseMany(result.handles);
       }
       proxyError(e);
     }
@@ -494,6 +517,7 @@ class AsyncProxyController<T> extends _Stateful {
       return;
     }
     final int status = _reader.channel.write(message.data, message.handles);
+    message.release();
     if (status != ZX.OK) {
       proxyError(FidlError(
           'AsyncProxyController<${$interfaceName}> failed to write to channel: ${_reader.channel} (status: $status)'));
@@ -511,6 +535,11 @@ class AsyncProxyController<T> extends _Stateful {
       return;
     }
 
+    if (synchronousCalls) {
+      _sendMessageWithResponseSync(message, completer);
+      return;
+    }
+
     const int _userspaceTxidMask = 0x7FFFFFFF;
 
     int txid = _nextTxid++ & _userspaceTxidMask;
@@ -519,6 +548,7 @@ class AsyncProxyController<T> extends _Stateful {
     message.txid = txid;
     _completerMap[message.txid] = completer;
     final int status = _reader.channel.write(message.data, message.handles);
+    message.release();
 
     if (status != ZX.OK) {
       proxyError(FidlError(
@@ -527,6 +557,32 @@ class AsyncProxyController<T> extends _Stateful {
     }
   }
 
+  void _sendMessageWithResponseSync(
+      Message message, Completer<dynamic> completer) {
+    // The kernel picks the txid, from a range userspace txids never use.
+    final ReadResult result = _reader.channel.callSync(message.data,
+        handles: message.handles, timeout: callTimeout);
+    message.release();
+    if (result.status != ZX.OK) {
+      final FidlError error = FidlError(
+          'AsyncProxyController<${$interfaceName}> failed to call on channel: ${_reader.channel} (status: ${result.status})');
+      completer.completeError(error);
+      proxyError(error);
+      return;
+    }
+
+    final int txid = Message.fromReadResult(result).txid;
+    _completerMap[txid] = completer;
+    _handleMessage(result);
+    if (!completer.isCompleted) {
+      // The reply could not be handled. Its entry may still be in the map if
+      // the proxy was not closed.
+      _completerMap.remove(txid);
+      completer.completeError(FidlError(
+          'AsyncProxyController<${$interfaceName}> could not handle the reply to a call'));
+    }
+  }
+
   /// Returns the completer associated with the given response message.
   ///
   /// Used by subclasses of [AsyncProxy<T>] to retrieve registered completers when
@@ -66,11 +66,18 @@ class Message {
         '==================================================');
   }
 
+  /// Gives the bytes of this message back to be reused once they have been
+  /// written to a channel.
+  ///
+  /// The bytes are not copied or detached: the next message encoded may be
+  /// written over them. Neither the message nor any view of [data] taken
+  /// before the call may be used afterwards, so code that needs the bytes of
+  /// a sent message must copy them before it is released.
+  void release() {}
+
   void closeHandles() {
-    if (handles != null) {
-      for (int i = 0; i < handles.length; ++i) {
-        handles[i].close();
-      }
+    if (handles != null && handles.isNotEmpty) {
+      System.handleCloseMany(handles);
     }
   }
 
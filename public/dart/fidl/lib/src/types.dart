@@ -12,6 +12,7 @@ import 'codec.dart';
 import 'enum.dart';
 import 'error.dart';
 import 'interface.dart';
+import 'message.dart';
 import 'struct.dart';
 import 'table.dart';
 import 'xunion.dart';
@@ -45,82 +46,28 @@ void _throwIfNotZero(int value) {
   }
 }
 
-void _copyInt8(ByteData data, Int8List value, int offset) {
-  final int count = value.length;
-  for (int i = 0; i < count; ++i) {
-    data.setInt8(offset + i, value[i]);
-  }
-}
+// Primitive vectors and arrays are copied to and from the message buffer in
+// bulk rather than element by element. FIDL is little-endian, as is every
+// host the bindings run on, so the bytes of a typed list are its encoding.
 
-void _copyUint8(ByteData data, Uint8List value, int offset) {
-  final int count = value.length;
-  for (int i = 0; i < count; ++i) {
-    data.setUint8(offset + i, value[i]);
-  }
+void _copyElements(ByteData data, TypedData elements, int offset) {
+  final int length = elements.lengthInBytes;
+  data.buffer.asUint8List(data.offsetInBytes + offset, length).setRange(
+      0, length, elements.buffer.asUint8List(elements.offsetInBytes, length));
 }
 
-void _copyInt16(ByteData data, Int16List value, int offset) {
-  final int count = value.length;
-  const int stride = 2;
-  for (int i = 0; i < count; ++i) {
-    data.setInt16(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyUint16(ByteData data, Uint16List value, int offset) {
-  final int count = value.length;
-  const int stride = 2;
-  for (int i = 0; i < count; ++i) {
-    data.setUint16(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyInt32(ByteData data, Int32List value, int offset) {
-  final int count = value.length;
-  const int stride = 4;
-  for (int i = 0; i < count; ++i) {
-    data.setInt32(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyUint32(ByteData data, Uint32List value, int offset) {
-  final int count = value.length;
-  const int stride = 4;
-  for (int i = 0; i < count; ++i) {
-    data.setUint32(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyInt64(ByteData data, Int64List value, int offset) {
-  final int count = value.length;
-  const int stride = 8;
-  for (int i = 0; i < count; ++i) {
-    data.setInt64(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyUint64(ByteData data, Uint64List value, int offset) {
-  final int count = value.length;
-  const int stride = 8;
-  for (int i = 0; i < count; ++i) {
-    data.setUint64(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyFloat32(ByteData data, Float32List value, int offset) {
-  final int count = value.length;
-  const int stride = 4;
-  for (int i = 0; i < count; ++i) {
-    data.setFloat32(offset + i * stride, value[i], Endian.little);
-  }
-}
-
-void _copyFloat64(ByteData data, Float64List value, int offset) {
-  final int count = value.length;
-  const int stride = 8;
-  for (int i = 0; i < count; ++i) {
-    data.setFloat64(offset + i * stride, value[i], Endian.little);
-  }
+// Returns [count] elements of [stride] bytes at [offset] as a view of the
+// message buffer, or as a copy if they are not aligned in it.
+T _viewElements<T>(Decoder decoder, int count, int offset, int stride,
+    T view(ByteBuffer buffer, int offsetInBytes, int length)) {
+  final ByteData data = decoder.data;
+  final int start = data.offsetInBytes + offset;
+  if (start % stride == 0) {
+    return view(data.buffer, start, count);
+  }
+  final Uint8List copy =
+      Uint8List.fromList(data.buffer.asUint8List(start, count * stride));
+  return view(copy.buffer, 0, count);
 }
 
 const int kAllocAbsent = 0;
@@ -128,6 +75,14 @@ const int kAllocPresent = 0xFFFFFFFFFFFFFFFF;
 const int kHandleAbsent = 0;
 const int kHandlePresent = 0xFFFFFFFF;
 
+// The encoders and decoders that fidlgen_dart generates for structs and
+// tables, which lay out their members straight-line with constant offsets.
+typedef EncodeFunction<T> = void Function(Encoder encoder, T value, int offset);
+typedef DecodeFunction<T> = T Function(Decoder decoder, int offset);
+
+// Creates a table that decodes its fields from [fields] when they are read.
+typedef LazyTableFactory<T> = T Function(LazyTableFields fields);
+
 abstract class FidlType<T> {
   const FidlType({this.inlineSize});
 
@@ -154,8 +109,9 @@ abstract class FidlType<T> {
 
   List<T> decodeArray(Decoder decoder, int count, int offset) {
     final List<T> list = List<T>(count);
+    final int stride = decodingInlineSize(decoder);
     for (int i = 0; i < count; ++i) {
-      list[i] = decode(decoder, offset + i * decodingInlineSize(decoder));
+      list[i] = decode(decoder, offset + i * stride);
     }
     return list;
   }
@@ -185,7 +141,7 @@ class UnknownRawDataType extends FidlType<UnknownRawData> {
 
   @override
   void encode(Encoder encoder, UnknownRawData value, int offset) {
-    _copyUint8(encoder.data, value.data, offset);
+    _copyElements(encoder.data, value.data, offset);
     for (int i = 0; i < value.handles.length; i++) {
       encoder.addHandle(value.handles[i]);
     }
@@ -193,10 +149,8 @@ class UnknownRawDataType extends FidlType<UnknownRawData> {
 
   @override
   UnknownRawData decode(Decoder decoder, int offset) {
-    final Uint8List data = Uint8List(numBytes);
-    for (var i = 0; i < numBytes; i++) {
-      data[i] = decoder.decodeUint8(offset + i);
-    }
+    final Uint8List data = Uint8List.fromList(decoder.data.buffer
+        .asUint8List(decoder.data.offsetInBytes + offset, numBytes));
     final handles = List<Handle>(numHandles);
     for (var i = 0; i < numHandles; i++) {
       handles[i] = decoder.claimHandle();
@@ -234,12 +188,14 @@ class Int8Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyInt8(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Int8List ? value : Int8List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asInt8List(offset, count);
+    return _viewElements(decoder, count, offset, 1,
+        (buffer, start, length) => buffer.asInt8List(start, length));
   }
 }
 
@@ -256,12 +212,14 @@ class Int16Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyInt16(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Int16List ? value : Int16List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asInt16List(offset, count);
+    return _viewElements(decoder, count, offset, 2,
+        (buffer, start, length) => buffer.asInt16List(start, length));
   }
 }
 
@@ -278,12 +236,14 @@ class Int32Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyInt32(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Int32List ? value : Int32List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asInt32List(offset, count);
+    return _viewElements(decoder, count, offset, 4,
+        (buffer, start, length) => buffer.asInt32List(start, length));
   }
 }
 
@@ -300,12 +260,14 @@ class Int64Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyInt64(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Int64List ? value : Int64List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asInt64List(offset, count);
+    return _viewElements(decoder, count, offset, 8,
+        (buffer, start, length) => buffer.asInt64List(start, length));
   }
 }
 
@@ -322,12 +284,14 @@ class Uint8Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyUint8(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Uint8List ? value : Uint8List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asUint8List(offset, count);
+    return _viewElements(decoder, count, offset, 1,
+        (buffer, start, length) => buffer.asUint8List(start, length));
   }
 }
 
@@ -344,12 +308,14 @@ class Uint16Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyUint16(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Uint16List ? value : Uint16List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asUint16List(offset, count);
+    return _viewElements(decoder, count, offset, 2,
+        (buffer, start, length) => buffer.asUint16List(start, length));
   }
 }
 
@@ -366,12 +332,14 @@ class Uint32Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyUint32(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Uint32List ? value : Uint32List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asUint32List(offset, count);
+    return _viewElements(decoder, count, offset, 4,
+        (buffer, start, length) => buffer.asUint32List(start, length));
   }
 }
 
@@ -388,12 +356,14 @@ class Uint64Type extends FidlType<int> {
 
   @override
   void encodeArray(Encoder encoder, List<int> value, int offset) {
-    _copyUint64(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Uint64List ? value : Uint64List.fromList(value), offset);
   }
 
   @override
   List<int> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asUint64List(offset, count);
+    return _viewElements(decoder, count, offset, 8,
+        (buffer, start, length) => buffer.asUint64List(start, length));
   }
 }
 
@@ -410,12 +380,14 @@ class Float32Type extends FidlType<double> {
 
   @override
   void encodeArray(Encoder encoder, List<double> value, int offset) {
-    _copyFloat32(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Float32List ? value : Float32List.fromList(value), offset);
   }
 
   @override
   List<double> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asFloat32List(offset, count);
+    return _viewElements(decoder, count, offset, 4,
+        (buffer, start, length) => buffer.asFloat32List(start, length));
   }
 }
 
@@ -432,12 +404,14 @@ class Float64Type extends FidlType<double> {
 
   @override
   void encodeArray(Encoder encoder, List<double> value, int offset) {
-    _copyFloat64(encoder.data, value, offset);
+    _copyElements(encoder.data,
+        value is Float64List ? value : Float64List.fromList(value), offset);
   }
 
   @override
   List<double> decodeArray(Decoder decoder, int count, int offset) {
-    return decoder.data.buffer.asFloat64List(offset, count);
+    return _viewElements(decoder, count, offset, 8,
+        (buffer, start, length) => buffer.asFloat64List(start, length));
   }
 }
 
@@ -610,7 +584,7 @@ class StringType extends NullableFidlType<String> {
       ..encodeUint64(size, offset) // size
       ..encodeUint64(kAllocPresent, offset + 8); // data
     int childOffset = encoder.alloc(size);
-    _copyUint8(encoder.data, bytes, childOffset);
+    _copyElements(encoder.data, bytes, childOffset);
   }
 
   @override
@@ -621,8 +595,8 @@ class StringType extends NullableFidlType<String> {
     if (data == kAllocAbsent) {
       return null;
     }
-    final Uint8List bytes =
-        decoder.data.buffer.asUint8List(decoder.claimMemory(size), size);
+    final int start = decoder.data.offsetInBytes + decoder.claimMemory(size);
+    final Uint8List bytes = decoder.data.buffer.asUint8List(start, size);
     try {
       return const Utf8Decoder().convert(bytes, 0, size);
     } on FormatException {
@@ -711,13 +685,24 @@ class StructType<T extends Struct> extends FidlType<T> {
     int inlineSize,
     this.members,
     this.ctor,
+    this.encodeFn,
+    this.decodeFn,
   }) : super(inlineSize: inlineSize);
 
   final List<MemberType> members;
   final StructFactory<T> ctor;
 
+  // Generated code for the members, used instead of walking [members] when
+  // present.
+  final EncodeFunction<T> encodeFn;
+  final DecodeFunction<T> decodeFn;
+
   @override
   void encode(Encoder encoder, T value, int offset) {
+    if (encodeFn != null) {
+      encodeFn(encoder, value, offset);
+      return;
+    }
     final int count = members.length;
     final List<Object> values = value.$fields;
     if (values.length != count) {
@@ -731,6 +716,9 @@ class StructType<T extends Struct> extends FidlType<T> {
 
   @override
   T decode(Decoder decoder, int offset) {
+    if (decodeFn != null) {
+      return decodeFn(decoder, offset);
+    }
     final int argc = members.length;
     final List<Object> argv = List<Object>(argc);
     for (int i = 0; i < argc; ++i) {
@@ -834,18 +822,147 @@ T _decodeEnvelopeContent<T>(Decoder decoder, _envelopeMode mode,
   }
 }
 
+// The building blocks of generated table encoders and decoders. Fields are
+// identified by ordinal, and the envelopes of fields past the largest
+// ordinal present are neither encoded nor decoded.
+
+/// Encodes the header of a table whose largest ordinal present is
+/// [maxOrdinal] and returns the offset of its envelopes.
+int encodeTableHeader(Encoder encoder, int maxOrdinal, int offset) {
+  encoder
+    ..encodeUint64(maxOrdinal, offset)
+    ..encodeUint64(kAllocPresent, offset + 8);
+  return maxOrdinal == 0 ? 0 : encoder.alloc(maxOrdinal * _kEnvelopeSize);
+}
+
+/// Encodes [field], which may be null, in the envelope for [ordinal].
+void encodeTableEnvelope<T>(Encoder encoder, int envelopes, int ordinal,
+    int maxOrdinal, T field, FidlType<T> fieldType) {
+  if (ordinal > maxOrdinal) {
+    return;
+  }
+  final int offset = envelopes + (ordinal - 1) * _kEnvelopeSize;
+  if (field != null) {
+    _encodeEnvelopePresent(encoder, offset, field, fieldType);
+  } else {
+    _encodeEnvelopeAbsent(encoder, offset);
+  }
+}
+
+/// Decodes the header of a table and returns the largest ordinal present.
+int decodeTableHeader(Decoder decoder, int offset) {
+  final int maxOrdinal = decoder.decodeUint64(offset);
+  final int data = decoder.decodeUint64(offset + 8);
+  switch (data) {
+    case kAllocPresent:
+      break; // good
+    case kAllocAbsent:
+      throw FidlError('Unexpected null reference');
+    default:
+      throw FidlError('Bad reference encoding');
+  }
+  return maxOrdinal;
+}
+
+/// Claims the envelopes of a table with fields up to [maxOrdinal].
+int claimTableEnvelopes(Decoder decoder, int maxOrdinal) {
+  return maxOrdinal == 0 ? 0 : decoder.claimMemory(maxOrdinal * _kEnvelopeSize);
+}
+
+/// Decodes the field for [ordinal], or skips it if [fieldType] is null.
+T decodeTableEnvelope<T>(Decoder decoder, int envelopes, int ordinal,
+    int maxOrdinal, FidlType<T> fieldType) {
+  if (ordinal > maxOrdinal) {
+    return null;
+  }
+  final int offset = envelopes + (ordinal - 1) * _kEnvelopeSize;
+  return _decodeEnvelope(
+      decoder, offset, _envelopeMode.kAllowUnknown, fieldType);
+}
+
+/// Skips the fields from [ordinal] to [maxOrdinal], which are unknown.
+void skipTableEnvelopes(
+    Decoder decoder, int envelopes, int ordinal, int maxOrdinal) {
+  for (; ordinal <= maxOrdinal; ordinal++) {
+    decodeTableEnvelope(decoder, envelopes, ordinal, maxOrdinal, null);
+  }
+}
+
+final Set<TableType> _lazyTableTypes = Set<TableType>.identity();
+
+/// Makes tables of [type] decode their fields when they are first read
+/// rather than when the message is decoded. This suits code that looks at a
+/// few fields of large tables, such as a router that only reads the field it
+/// routes on.
+///
+/// The table's envelopes are still validated and claimed up front, and fields
+/// that carry handles are decoded right away so that every handle has an
+/// owner. The other fields are decoded on first read, which throws a
+/// [FidlError] if they turn out to be malformed. A lazily decoded table keeps
+/// a reference to the bytes of its message.
+void enableLazyDecoding(TableType type) {
+  _lazyTableTypes.add(type);
+}
+
+/// The fields of a lazily decoded table, see [enableLazyDecoding].
+class LazyTableFields {
+  LazyTableFields._(this._data, this._offsets, this._headers, this._values);
+
+  final ByteData _data;
+  // The offset in [_data] of each field that is yet to be decoded, or -1.
+  final List<int> _offsets;
+  final List<EnvelopeHeader> _headers;
+  final List<Object> _values;
+
+  /// Returns the field for [ordinal], decoding it as a [type] on first read.
+  T field<T>(int ordinal, FidlType<T> type) {
+    final int index = ordinal - 1;
+    if (index >= _offsets.length) {
+      return null;
+    }
+    final int offset = _offsets[index];
+    if (offset >= 0) {
+      final EnvelopeHeader header = _headers[index];
+      final Decoder decoder = Decoder.fromRawArgs(
+          ByteData.view(
+              _data.buffer, _data.offsetInBytes + offset, header.numBytes),
+          <Handle>[]);
+      _values[index] = _decodeEnvelopeContent(
+          decoder, _envelopeMode.kAllowUnknown, header, type);
+      _offsets[index] = -1;
+      _headers[index] = null;
+    }
+    return _values[index];
+  }
+}
+
 class TableType<T extends Table> extends FidlType<T> {
   const TableType({
     int inlineSize,
     this.members,
     this.ctor,
+    this.encodeFn,
+    this.decodeFn,
+    this.lazyCtor,
   }) : super(inlineSize: inlineSize);
 
   final Map<int, FidlType> members;
   final TableFactory<T> ctor;
 
+  // Generated code for the fields, used instead of walking [members] when
+  // present.
+  final EncodeFunction<T> encodeFn;
+  final DecodeFunction<T> decodeFn;
+
+  // Used once the type is opted in with [enableLazyDecoding].
+  final LazyTableFactory<T> lazyCtor;
+
   @override
   void encode(Encoder encoder, T value, int offset) {
+    if (encodeFn != null) {
+      encodeFn(encoder, value, offset);
+      return;
+    }
     // Determining max ordinal.
     int maxOrdinal = 0;
     value.$fields.forEach((ordinal, field) {
@@ -889,18 +1006,18 @@ class TableType<T extends Table> extends FidlType<T> {
 
   @override
   T decode(Decoder decoder, int offset) {
-    // Header.
-    final int maxOrdinal = decoder.decodeUint64(offset);
-    final int data = decoder.decodeUint64(offset + 8);
-    switch (data) {
-      case kAllocPresent:
-        break; // good
-      case kAllocAbsent:
-        throw FidlError('Unexpected null reference');
-      default:
-        throw FidlError('Bad reference encoding');
+    if (lazyCtor != null &&
+        _lazyTableTypes.isNotEmpty &&
+        _lazyTableTypes.contains(this)) {
+      return lazyCtor(_decodeLazily(decoder, offset));
+    }
+    if (decodeFn != null) {
+      return decodeFn(decoder, offset);
     }
 
+    // Header.
+    final int maxOrdinal = decodeTableHeader(decoder, offset);
+
     // Early exit on empty table.
     if (maxOrdinal == 0) {
       return ctor({});
@@ -921,6 +1038,29 @@ class TableType<T extends Table> extends FidlType<T> {
 
     return ctor(argv);
   }
+
+  LazyTableFields _decodeLazily(Decoder decoder, int offset) {
+    final int maxOrdinal = decodeTableHeader(decoder, offset);
+    final int envelopes = claimTableEnvelopes(decoder, maxOrdinal);
+    final List<int> offsets = List<int>.filled(maxOrdinal, -1);
+    final List<EnvelopeHeader> headers = List<EnvelopeHeader>(maxOrdinal);
+    final List<Object> values = List<Object>(maxOrdinal);
+    for (int i = 0; i < maxOrdinal; i++) {
+      final EnvelopeHeader header =
+          _decodeEnvelopeHeader(decoder, envelopes + i * _kEnvelopeSize);
+      final FidlType fieldType = members[i + 1];
+      if (fieldType != null &&
+          header.fieldPresent == kAllocPresent &&
+          header.numHandles == 0) {
+        offsets[i] = decoder.claimMemory(header.numBytes);
+        headers[i] = header;
+      } else {
+        values[i] = _decodeEnvelopeContent(
+            decoder, _envelopeMode.kAllowUnknown, header, fieldType);
+      }
+    }
+    return LazyTableFields._(decoder.data, offsets, headers, values);
+  }
 }
 
 class XUnionType<T extends XUnion> extends NullableFidlType<T> {
@@ -1041,6 +1181,8 @@ class MethodType extends FidlType<Null> {
     this.name,
     this.requestInlineSize,
     this.responseInlineSize,
+    this.requestSizeHint = kMessageHeaderSize,
+    this.responseSizeHint = kMessageHeaderSize,
   });
 
   final List<MemberType> request;
@@ -1049,6 +1191,11 @@ class MethodType extends FidlType<Null> {
   final int requestInlineSize;
   final int responseInlineSize;
 
+  // The most bytes a request or response message can encode to, including
+  // the header, which its encoder is presized for.
+  final int requestSizeHint;
+  final int responseSizeHint;
+
   int encodingRequestInlineSize(Encoder encoder) {
     return requestInlineSize;
   }
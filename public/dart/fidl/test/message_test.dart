@@ -0,0 +1,37 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:fidl/fidl.dart';
+import 'package:test/test.dart';
+import 'package:zircon/zircon.dart';
+
+class _CountingHandle extends Handle {
+  _CountingHandle() : super.invalid();
+
+  int closeCount = 0;
+
+  @override
+  int close() {
+    closeCount++;
+    return 0;
+  }
+}
+
+void main() {
+  group('message', () {
+    test('closeHandles closes every handle', () {
+      final handles = [_CountingHandle(), _CountingHandle()];
+      Message(ByteData(kMessageHeaderSize), handles).closeHandles();
+      for (final handle in handles) {
+        expect(handle.closeCount, equals(1));
+      }
+    });
+
+    test('closeHandles accepts a message without handles', () {
+      Message(ByteData(kMessageHeaderSize), []).closeHandles();
+    });
+  });
+}
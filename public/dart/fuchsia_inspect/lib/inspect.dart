@@ -8,6 +8,7 @@ export 'src/inspect/inspect.dart'
         uniqueName,
         Inspect,
         InspectStateError,
+        NativeStatsExporter,
         Node,
         IntProperty,
         DoubleProperty,
@@ -4,6 +4,7 @@
 
 library topaz.public.dart.fuchsia_inspect.inspect.inspect;
 
+import 'dart:async';
 import 'dart:typed_data';
 
 import 'package:fuchsia_services/services.dart';
@@ -15,6 +16,7 @@ import '../testing/util.dart' show FakeVmoHolder;
 import '../vmo/vmo_writer.dart';
 import 'internal/_inspect_impl.dart';
 
+part 'native_stats.dart';
 part 'node.dart';
 part 'property.dart';
 
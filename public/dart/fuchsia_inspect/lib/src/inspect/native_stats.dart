@@ -0,0 +1,57 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of 'inspect.dart';
+
+/// Publishes the isolate's [NativeStats] as a subtree of a [Node].
+///
+/// Each native that has been called gets a child node with its `calls`,
+/// `errors`, `bytes` and `handles`, and a `latency_us` child that maps the
+/// lower bound of each latency bucket, in microseconds, to its count.
+///
+/// Inspect is written, not read on demand, so the subtree is refreshed by
+/// [update], or periodically after [start].
+class NativeStatsExporter {
+  final Node _node;
+  Timer _timer;
+
+  /// Creates an exporter that writes under [node], and enables
+  /// [NativeStats].
+  NativeStatsExporter(this._node) {
+    NativeStats.enable();
+  }
+
+  /// Writes the current counters.
+  void update() {
+    for (NativeCallStats stats in NativeStats.snapshot()) {
+      if (stats.calls == 0) {
+        continue;
+      }
+      final Node node = _node.child(stats.name)
+        ..intProperty('calls').setValue(stats.calls)
+        ..intProperty('errors').setValue(stats.errors)
+        ..intProperty('bytes').setValue(stats.bytes)
+        ..intProperty('handles').setValue(stats.handles);
+      final Node latency = node.child('latency_us');
+      for (int i = 0; i < stats.latencyHistogram.length; i++) {
+        final int lowerBound = i == 0 ? 0 : 1 << (i - 1);
+        latency
+            .intProperty('$lowerBound')
+            .setValue(stats.latencyHistogram[i]);
+      }
+    }
+  }
+
+  /// Calls [update] every [interval] until [stop] is called.
+  void start(Duration interval) {
+    _timer?.cancel();
+    _timer = Timer.periodic(interval, (_) => update());
+  }
+
+  /// Stops periodic updates. Counting continues.
+  void stop() {
+    _timer?.cancel();
+    _timer = null;
+  }
+}
@@ -12,10 +12,10 @@ class VmoHolder {
   final int size;
   Vmo _vmo;
 
-  /// Dart currently requires a syscall to write to a VMO, but provides a way
-  /// to map it read-only. [_shadow] will hold that map to avoid syscall
-  /// overhead on reads.
+  /// A writable mapping of the whole VMO, so that reads and block updates
+  /// avoid syscall overhead.
   Uint8List _shadow;
+  ByteData _shadowData;
 
   /// Creates and holds a VMO of desired size.
   VmoHolder(this.size) {
@@ -24,7 +24,8 @@ class VmoHolder {
       throw ZxStatusException(result.status, getStringForStatus(result.status));
     }
     _vmo = Vmo(result.handle);
-    _shadow = _vmo.map();
+    _shadow = _vmo.mapRange(writable: true);
+    _shadowData = ByteData.view(_shadow.buffer, _shadow.offsetInBytes, size);
   }
 
   /// The raw VMO
@@ -40,33 +41,34 @@ class VmoHolder {
   ///
   /// Data will be visible to other processes by end of next commit().
   void write(int offset, ByteData data) {
-    int status = _vmo.write(data, offset);
-    if (status != ZX.OK) {
-      throw ZxStatusException(status, getStringForStatus(status));
-    }
+    _shadow.setAll(offset,
+        data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes));
   }
 
   /// Reads data from VMO at byte offset (not index).
   ByteData read(int offset, int size) =>
-      ByteData.view(_shadow.buffer, offset, size);
+      ByteData.view(_shadow.buffer, _shadow.offsetInBytes + offset, size);
 
   /// Writes int64 to VMO.
   ///
   /// Data will be visible to other processes by end of next commit().
   void writeInt64(int offset, int value) {
-    var data = ByteData(8)..setInt64(0, value, Endian.little);
-    write(offset, data);
+    _shadowData.setInt64(offset, value, Endian.little);
   }
 
   /// Writes int64 directly to VMO for immediate visibility.
+  ///
+  /// This goes through a syscall rather than the mapping: it is used for the
+  /// header generation count, and the syscall orders it with respect to the
+  /// block updates it guards, which plain Dart stores cannot guarantee.
   void writeInt64Direct(int offset, int value) {
     var data = ByteData(8)..setInt64(0, value, Endian.little);
-    write(offset, data);
+    int status = _vmo.write(data, offset);
+    if (status != ZX.OK) {
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
   }
 
   /// Reads int64 from VMO.
-  int readInt64(int offset) {
-    ByteData data = read(offset, 8);
-    return data.getInt64(0, Endian.little);
-  }
+  int readInt64(int offset) => _shadowData.getInt64(offset, Endian.little);
 }
@@ -0,0 +1,99 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// ignore_for_file: implementation_imports
+
+import 'dart:typed_data';
+
+import 'package:fuchsia_inspect/inspect.dart';
+import 'package:fuchsia_inspect/testing.dart';
+import 'package:fuchsia_inspect/src/inspect/internal/_inspect_impl.dart';
+import 'package:fuchsia_inspect/src/vmo/vmo_writer.dart';
+import 'package:fuchsia_services/services.dart';
+import 'package:test/test.dart';
+import 'package:zircon/zircon.dart';
+
+void main() {
+  FakeVmoHolder vmo;
+  Node root;
+  Uint64List values;
+  int stride;
+
+  // Sets the counters of the native [name] as the natives would.
+  void record(String name, int calls, int errors, int bytes, int handles,
+      int latencyBucket) {
+    final int base = System.getNativeStatsNames().indexOf(name) * stride;
+    values
+      ..[base] = calls
+      ..[base + 1] = errors
+      ..[base + 2] = bytes
+      ..[base + 3] = handles
+      ..[base + 4 + latencyBucket] = calls;
+  }
+
+  setUp(() {
+    var context = StartupContext.fromStartupInfo();
+    vmo = FakeVmoHolder(64 * 1024);
+    var writer = VmoWriter.withVmo(vmo);
+    Inspect inspect =
+        InspectImpl(context.outgoing.diagnosticsDir(), 'root.inspect', writer);
+    root = inspect.root;
+    values = System.getNativeStats();
+    values.fillRange(0, values.length, 0);
+    stride = values.length ~/ System.getNativeStatsNames().length;
+  });
+
+  test('exports the natives that have been called', () {
+    record('Channel.write', 3, 1, 96, 2, 4);
+    NativeStatsExporter(root.child('natives')).update();
+
+    var natives = VmoMatcher(vmo).node().at(['natives']);
+    expect(
+        natives.at(['Channel.write'])
+          ..propertyEquals('calls', 3)
+          ..propertyEquals('errors', 1)
+          ..propertyEquals('bytes', 96)
+          ..propertyEquals('handles', 2),
+        hasNoErrors);
+    expect(
+        natives.at(['Channel.write', 'latency_us'])
+          ..propertyEquals('0', 0)
+          ..propertyEquals('8', 3),
+        hasNoErrors);
+    expect(natives..missingChild('Channel.read'), hasNoErrors);
+  });
+
+  test('updates track the counters', () {
+    final exporter = NativeStatsExporter(root.child('natives'));
+    record('Socket.read', 1, 0, 16, 0, 0);
+    exporter.update();
+    record('Socket.read', 5, 2, 80, 0, 0);
+    record('Handle.close', 4, 0, 0, 4, 1);
+    exporter.update();
+
+    var natives = VmoMatcher(vmo).node().at(['natives']);
+    expect(
+        natives.at(['Socket.read'])
+          ..propertyEquals('calls', 5)
+          ..propertyEquals('errors', 2)
+          ..propertyEquals('bytes', 80),
+        hasNoErrors);
+    expect(
+        natives.at(['Handle.close'])
+          ..propertyEquals('calls', 4)
+          ..propertyEquals('handles', 4),
+        hasNoErrors);
+  });
+
+  test('repeated updates reuse the same nodes and properties', () {
+    final exporter = NativeStatsExporter(root.child('natives'));
+    record('Vmo.read', 2, 0, 32, 0, 2);
+    exporter.update();
+    // Skip the header, whose generation count changes with every write.
+    final exported = Uint8List.fromList(vmo.bytes.buffer.asUint8List(16));
+    exporter.update();
+
+    expect(vmo.bytes.buffer.asUint8List(16), equals(exported));
+  });
+}
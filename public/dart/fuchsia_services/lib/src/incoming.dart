@@ -34,6 +34,9 @@ import 'package:zircon/zircon.dart';
 class Incoming {
   DirectoryProxy _dirProxy;
 
+  // Where the directory is mounted in this component's namespace, if it is.
+  final String _namespacePath;
+
   /// Initializes [Incoming] with an unbound [DirectoryProxy] which can be used
   /// to bind to a launched component's services.
   Incoming() : this.withDirectory(DirectoryProxy());
@@ -43,7 +46,20 @@ class Incoming {
   ///
   /// If you are launching a component use the [Incoming()] constructor
   /// to get an unbound directory.
-  Incoming.withDirectory(this._dirProxy) : assert(_dirProxy != null);
+  Incoming.withDirectory(this._dirProxy)
+      : assert(_dirProxy != null),
+        _namespacePath = null;
+
+  /// Initializes [Incoming] with a [Directory] that is bound to [path] in
+  /// this component's namespace, such as `/svc`.
+  ///
+  /// This lets [connectToServices] connect to many services in a single
+  /// native call through the namespace. The other methods still open services
+  /// through the [Directory].
+  Incoming.withNamespaceDirectory(this._dirProxy, String path)
+      : assert(_dirProxy != null),
+        assert(path != null),
+        _namespacePath = path;
 
   /// Terminates connection and return Zircon status.
   Future<int> close() async {
@@ -60,12 +76,7 @@ class Incoming {
     if (serviceProxy == null) {
       throw ArgumentError.notNull('serviceProxy');
     }
-    final String serviceName = serviceProxy.ctrl.$serviceName;
-    if (serviceName == null) {
-      throw Exception(
-          "${serviceProxy.ctrl.$interfaceName}'s controller.\$serviceName must "
-          'not be null. Check the FIDL file for a missing [Discoverable]');
-    }
+    final String serviceName = _serviceNameOf(serviceProxy);
 
     // Creates an interface request and binds one of the channels. Binding this
     // channel prior to connecting to the agent allows the developer to make
@@ -76,6 +87,67 @@ class Incoming {
         serviceName, serviceProxyRequest.passChannel());
   }
 
+  /// Connects to the incoming services specified by [serviceProxies].
+  ///
+  /// When this object was created with [Incoming.withNamespaceDirectory],
+  /// all the connections are made in a single native call, which closes
+  /// every proxy and throws a [ZxStatusException] if one of them fails. Otherwise this is the same as
+  /// calling [connectToService] for each proxy.
+  ///
+  /// If this object is not bound via the [request] method before
+  /// this method is called an [IncomingStateException] will be thrown.
+  void connectToServices(List<AsyncProxy<dynamic>> serviceProxies) {
+    if (serviceProxies == null) {
+      throw ArgumentError.notNull('serviceProxies');
+    }
+    if (_namespacePath == null) {
+      for (final AsyncProxy<dynamic> serviceProxy in serviceProxies) {
+        connectToService(serviceProxy);
+      }
+      return;
+    }
+    _checkBound();
+
+    final List<String> paths = <String>[];
+    final List<Handle> channels = <Handle>[];
+    for (final AsyncProxy<dynamic> serviceProxy in serviceProxies) {
+      if (serviceProxy == null) {
+        throw ArgumentError.notNull('serviceProxy');
+      }
+      paths.add('$_namespacePath/${_serviceNameOf(serviceProxy)}');
+    }
+    for (final AsyncProxy<dynamic> serviceProxy in serviceProxies) {
+      channels.add(serviceProxy.ctrl.request().passChannel().passHandle());
+    }
+    final int status = System.connectToServices(paths, channels);
+    if (status != ZX.OK) {
+      // Some of the proxies may not be connected to anything, so calls on
+      // them would never complete.
+      for (final AsyncProxy<dynamic> serviceProxy in serviceProxies) {
+        serviceProxy.ctrl.close();
+      }
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+  }
+
+  void _checkBound() {
+    if (_dirProxy.ctrl.isUnbound) {
+      throw IncomingStateException(
+          'The directory must be bound before trying to connect to a service. '
+          'See [Incoming.request] for more information');
+    }
+  }
+
+  String _serviceNameOf(AsyncProxy<dynamic> serviceProxy) {
+    final String serviceName = serviceProxy.ctrl.$serviceName;
+    if (serviceName == null) {
+      throw Exception(
+          "${serviceProxy.ctrl.$interfaceName}'s controller.\$serviceName must "
+          'not be null. Check the FIDL file for a missing [Discoverable]');
+    }
+    return serviceName;
+  }
+
   /// Connects to the incoming service specified by [serviceName] through the
   /// [channel] endpoint supplied by the caller.
   ///
@@ -94,11 +166,7 @@ class Incoming {
       throw ArgumentError.notNull('channel');
     }
 
-    if (_dirProxy.ctrl.isUnbound) {
-      throw IncomingStateException(
-          'The directory must be bound before trying to connect to a service. '
-          'See [Incoming.request] for more information');
-    }
+    _checkBound();
 
     // connection flags for service: can read & write from target object.
     const int _openFlags = openRightReadable | openRightWritable;
@@ -125,13 +193,7 @@ class Incoming {
     if (channel == null) {
       throw ArgumentError.notNull('channel');
     }
-    final String serviceName = serviceProxy.ctrl.$serviceName;
-    if (serviceName == null) {
-      throw Exception(
-          "${serviceProxy.ctrl.$interfaceName}'s controller.\$serviceName must "
-          'not be null. Check the FIDL file for a missing [Discoverable]');
-    }
-    connectToServiceByNameWithChannel(serviceName, channel);
+    connectToServiceByNameWithChannel(_serviceNameOf(serviceProxy), channel);
   }
 
   /// Takes ownership of the Directory's request object for binding
@@ -64,7 +64,8 @@ class StartupContextImpl implements StartupContext {
       final channel = Channel.fromFile(_serviceRootPath);
       final directory = fidl_io.DirectoryProxy()
         ..ctrl.bind(InterfaceHandle<fidl_io.Directory>(channel));
-      final incoming = Incoming.withDirectory(directory);
+      final incoming =
+          Incoming.withNamespaceDirectory(directory, _serviceRootPath);
 
       // Note takeOutgoingServices shouldn't be called more than once per pid
       final outgoingServicesHandle = MxStartupInfo.takeOutgoingServices();
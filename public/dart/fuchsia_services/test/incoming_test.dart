@@ -10,6 +10,7 @@ import 'package:fidl_test_fuchsia_service_foo/fidl_async.dart';
 import 'package:fuchsia_services/src/incoming.dart';
 import 'package:fuchsia_services/src/outgoing.dart';
 import 'package:fidl_fuchsia_io/fidl_async.dart';
+import 'package:fidl_fuchsia_sys/fidl_async.dart';
 import 'package:test/test.dart';
 import 'package:zircon/zircon.dart';
 
@@ -114,10 +115,55 @@ void main() {
       }));
     });
 
+    test('Successfully connectToServices', () async {
+      // verify connecting to fooProxy via incoming is successful
+      _incoming.connectToServices([fooProxy]);
+
+      // by asserting on the stream response
+      connectorStream.listen(expectAsync1((response) {
+        expect(response, true);
+      }));
+    });
+
     test('Throws exception if directory is not bound', () {
       // Do not use _incoming since its directory is bound in setup
       expect(() => Incoming().connectToService(fooProxy),
           throwsA(const TypeMatcher<IncomingStateException>()));
     });
   });
+
+  group('namespace connections:', () {
+    Incoming namespaceIncoming(String path) {
+      final directory = DirectoryProxy()
+        ..ctrl.bind(InterfaceHandle<Directory>(Channel.fromFile('/svc')));
+      return Incoming.withNamespaceDirectory(directory, path);
+    }
+
+    test('connectToServices connects through the namespace', () {
+      final launcherProxy = LauncherProxy();
+      final environmentProxy = EnvironmentProxy();
+      namespaceIncoming('/svc')
+          .connectToServices([launcherProxy, environmentProxy]);
+      expect(launcherProxy.ctrl.isBound, isTrue);
+      expect(environmentProxy.ctrl.isBound, isTrue);
+      launcherProxy.ctrl.close();
+      environmentProxy.ctrl.close();
+    });
+
+    test('connectToServices throws if a path is not in the namespace', () {
+      final launcherProxy = LauncherProxy();
+      expect(
+          () => namespaceIncoming('/no/such/directory')
+              .connectToServices([launcherProxy]),
+          throwsA(const TypeMatcher<ZxStatusException>()));
+      expect(launcherProxy.ctrl.isBound, isFalse);
+    });
+
+    test('connectToServices throws if directory is not bound', () {
+      expect(
+          () => Incoming.withNamespaceDirectory(DirectoryProxy(), '/svc')
+              .connectToServices([LauncherProxy()]),
+          throwsA(const TypeMatcher<IncomingStateException>()));
+    });
+  });
 }
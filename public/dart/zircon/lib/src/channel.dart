@@ -34,6 +34,9 @@ class Channel extends _HandleWrapper<Channel> {
   static const int MAX_MSG_BYTES = ZX.CHANNEL_MAX_MSG_BYTES;
   static const int MAX_MSG_HANDLES = ZX.CHANNEL_MAX_MSG_HANDLES;
 
+  // Deadline for a call that waits forever.
+  static const int TIME_INFINITE = 0x7FFFFFFFFFFFFFFF;
+
   int write(ByteData data, [List<Handle> handles]) {
     if (handle == null) {
       return ZX.ERR_INVALID_ARGS;
@@ -42,12 +45,63 @@ class Channel extends _HandleWrapper<Channel> {
     return System.channelWrite(handle, data, handles);
   }
 
+  /// Writes a single message made of the concatenation of [segments], each
+  /// of which must be a [ByteData] or [Uint8List].
+  ///
+  /// The segments are gathered natively, so callers holding a header and a
+  /// large payload separately do not have to copy them together first.
+  int writeV(List<TypedData> segments, [List<Handle> handles]) {
+    if (handle == null) {
+      return ZX.ERR_INVALID_ARGS;
+    }
+
+    return System.channelWriteV(handle, segments, handles ?? <Handle>[]);
+  }
+
+  /// Reads the next message from the channel with a single syscall.
+  ReadResult read() {
+    if (handle == null) {
+      return const ReadResult(ZX.ERR_INVALID_ARGS);
+    }
+    return System.channelRead(handle);
+  }
+
+  /// Writes [data] and [handles] as a request and blocks until its reply
+  /// arrives, or until [timeout] passes, in which case the status is
+  /// [ZX.ERR_TIMED_OUT].
+  ///
+  /// The kernel sets the txid in the first four bytes of [data] and returns
+  /// only the reply carrying the same txid. Other messages stay queued.
+  ReadResult callSync(ByteData data,
+      {List<Handle> handles, Duration timeout}) {
+    if (handle == null) {
+      return const ReadResult(ZX.ERR_INVALID_ARGS);
+    }
+    final int deadline = timeout == null
+        ? TIME_INFINITE
+        : System.clockGet(ZX.CLOCK_MONOTONIC) + timeout.inMicroseconds * 1000;
+    return System.channelCall(handle, data, handles, deadline);
+  }
+
   ReadResult queryAndRead() {
     if (handle == null) {
       return const ReadResult(ZX.ERR_INVALID_ARGS);
     }
     return System.channelQueryAndRead(handle);
   }
+
+  /// Reads up to [maxMessages] queued messages in a single native call.
+  ///
+  /// Reading stops before a message that would take the batch past
+  /// [maxBytes], although the first message is always returned. At most 64
+  /// messages are read per call, whatever [maxMessages] is.
+  ReadBatchResult readBatch(
+      {int maxMessages = 16, int maxBytes = MAX_MSG_BYTES}) {
+    if (handle == null) {
+      return const ReadBatchResult(ZX.ERR_INVALID_ARGS);
+    }
+    return System.channelReadBatch(handle, maxMessages, maxBytes);
+  }
 }
 
 /// Typed wrapper around a linked pair of channel objects and the
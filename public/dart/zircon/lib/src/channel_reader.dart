@@ -17,6 +17,7 @@ class ChannelReaderError {
 }
 
 typedef ChannelReaderReadableHandler = void Function();
+typedef ChannelReaderMessagesHandler = void Function(ReadBatchResult batch);
 typedef ChannelReaderErrorHandler = void Function(ChannelReaderError error);
 
 class ChannelReader {
@@ -26,10 +27,24 @@ class ChannelReader {
   bool get isBound => _channel != null;
 
   HandleWaiter _waiter;
+  WaitSetWaiter _setWaiter;
+
+  /// When set before [bind], the reader waits for messages through this
+  /// shared set instead of registering its own waits.
+  WaitSet waitSet;
 
   ChannelReaderReadableHandler onReadable;
   ChannelReaderErrorHandler onError;
 
+  /// When set, the reader drains the channel itself with
+  /// [Channel.readBatch] on every readable signal and hands each batch to
+  /// this handler instead of calling [onReadable].
+  ChannelReaderMessagesHandler onMessages;
+
+  /// Limits applied to each batch delivered to [onMessages].
+  int batchMaxMessages = 16;
+  int batchMaxBytes = Channel.MAX_MSG_BYTES;
+
   void bind(Channel channel) {
     if (isBound) {
       throw ZirconApiError('ChannelReader is already bound.');
@@ -42,7 +57,7 @@ class ChannelReader {
     if (!isBound) {
       throw ZirconApiError('ChannelReader is not bound');
     }
-    _waiter?.cancel();
+    _cancelWait();
     final Channel result = _channel;
     _channel = null;
     return result;
@@ -52,14 +67,28 @@ class ChannelReader {
     if (!isBound) {
       return;
     }
-    _waiter.cancel();
+    _cancelWait();
     _channel.close();
     _channel = null;
   }
 
   void _asyncWait() {
-    _waiter = _channel.handle
-        .asyncWait(Channel.READABLE | Channel.PEER_CLOSED, _handleWaitComplete);
+    if (waitSet != null) {
+      _setWaiter = waitSet.asyncWait(_channel.handle,
+          Channel.READABLE | Channel.PEER_CLOSED, _handleWaitComplete);
+    } else {
+      // The waiter stays armed across messages until it is cancelled or only
+      // peer-closed is left to report.
+      _waiter = _channel.handle.asyncWaitPersistent(
+          Channel.READABLE | Channel.PEER_CLOSED, _handleWaitComplete);
+    }
+  }
+
+  void _cancelWait() {
+    _waiter?.cancel();
+    _waiter = null;
+    _setWaiter?.cancel();
+    _setWaiter = null;
   }
 
   void _errorSoon(ChannelReaderError error) {
@@ -75,6 +104,18 @@ class ChannelReader {
     });
   }
 
+  void _readBatch() {
+    final ReadBatchResult batch = _channel.readBatch(
+        maxMessages: batchMaxMessages, maxBytes: batchMaxBytes);
+    if (batch.status == ZX.ERR_SHOULD_WAIT) {
+      return;
+    }
+    if (batch.status != ZX.OK) {
+      throw ZxStatusException(batch.status, getStringForStatus(batch.status));
+    }
+    onMessages(batch);
+  }
+
   @override
   String toString() => 'ChannelReader($_channel)';
 
@@ -91,10 +132,13 @@ class ChannelReader {
     // RawReceivePort any more.
     try {
       if ((pending & Channel.READABLE) != 0) {
-        if (onReadable != null) {
+        if (onMessages != null) {
+          _readBatch();
+        } else if (onReadable != null) {
           onReadable();
         }
-        if (isBound) {
+        // Waits from a WaitSet are one-shot.
+        if (isBound && _setWaiter != null) {
           _asyncWait();
         }
       } else if ((pending & Channel.PEER_CLOSED) != 0) {
@@ -37,8 +37,18 @@ class Handle {
         'Handle.asyncWait() is not implemented on this platform.');
   }
 
+  HandleWaiter asyncWaitPersistent(int signals, AsyncWaitCallback callback) {
+    throw UnimplementedError(
+        'Handle.asyncWaitPersistent() is not implemented on this platform.');
+  }
+
   Handle duplicate(int options) {
     throw UnimplementedError(
         'Handle.duplicate() is not implemented on this platform.');
   }
+
+  Handle replace(int rights) {
+    throw UnimplementedError(
+        'Handle.replace() is not implemented on this platform.');
+  }
 }
@@ -67,6 +67,35 @@ class ReadResult extends _Result {
       'ReadResult(status=$status, bytes=$bytes, numBytes=$numBytes, handles=$handles)';
 }
 
+class ReadBatchResult extends _Result {
+  final ByteData bytes;
+  final Uint32List byteOffsets;
+  final Uint32List handleOffsets;
+  final List<Handle> handles;
+  const ReadBatchResult(final int status,
+      [this.bytes, this.byteOffsets, this.handleOffsets, this.handles])
+      : super(status);
+
+  /// The number of messages packed into [bytes].
+  int get numMessages => byteOffsets == null ? 0 : byteOffsets.length - 1;
+
+  /// Returns the [index]th message of the batch as a [ReadResult] whose bytes
+  /// are a view into [bytes].
+  ReadResult messageAt(int index) {
+    final int start = byteOffsets[index];
+    final int numBytes = byteOffsets[index + 1] - start;
+    return ReadResult(
+        status,
+        bytes.buffer.asByteData(bytes.offsetInBytes + start, numBytes),
+        numBytes,
+        handles.sublist(handleOffsets[index], handleOffsets[index + 1]));
+  }
+
+  @override
+  String toString() =>
+      'ReadBatchResult(status=$status, numMessages=$numMessages, handles=$handles)';
+}
+
 class WriteResult extends _Result {
   final int numBytes;
   const WriteResult(final int status, [this.numBytes]) : super(status);
@@ -93,9 +122,10 @@ class FromFileResult extends _Result {
 
 class MapResult extends _Result {
   final Uint8List data;
-  const MapResult(final int status, [this.data]) : super(status);
+  final Handle region;
+  const MapResult(final int status, [this.data, this.region]) : super(status);
   @override
-  String toString() => 'MapResult(status=$status, data=$data)';
+  String toString() => 'MapResult(status=$status, data=$data, region=$region)';
 }
 
 class System {
@@ -118,11 +148,34 @@ class System {
         'System.channelWrite() is not implemented on this platform.');
   }
 
+  static int channelWriteV(
+      Handle channel, List<TypedData> segments, List<Handle> handles) {
+    throw UnimplementedError(
+        'System.channelWriteV() is not implemented on this platform.');
+  }
+
+  static ReadResult channelRead(Handle channel) {
+    throw UnimplementedError(
+        'System.channelRead() is not implemented on this platform.');
+  }
+
   static ReadResult channelQueryAndRead(Handle channel) {
     throw UnimplementedError(
         'System.channelQueryAndRead() is not implemented on this platform.');
   }
 
+  static ReadBatchResult channelReadBatch(
+      Handle channel, int maxMessages, int maxBytes) {
+    throw UnimplementedError(
+        'System.channelReadBatch() is not implemented on this platform.');
+  }
+
+  static ReadResult channelCall(
+      Handle channel, ByteData data, List<Handle> handles, int deadline) {
+    throw UnimplementedError(
+        'System.channelCall() is not implemented on this platform.');
+  }
+
   // Eventpair operations.
   static HandlePairResult eventpairCreate([int options = 0]) {
     throw UnimplementedError(
@@ -145,6 +198,12 @@ class System {
         'System.socketRead() is not implemented on this platform.');
   }
 
+  static int socketReadInto(
+      Handle socket, ByteData target, int targetOffset, int size) {
+    throw UnimplementedError(
+        'System.socketReadInto() is not implemented on this platform.');
+  }
+
   // Vmo operations.
   static HandleResult vmoCreate(int size, [int options = 0]) {
     throw UnimplementedError(
@@ -176,20 +235,142 @@ class System {
         'System.vmoRead() is not implemented on this platform.');
   }
 
+  static int vmoReadInto(
+      Handle vmo, int offset, ByteData target, int targetOffset, int size) {
+    throw UnimplementedError(
+        'System.vmoReadInto() is not implemented on this platform.');
+  }
+
   static MapResult vmoMap(Handle vmo) {
     throw UnimplementedError(
         'System.vmoMap() is not implemented on this platform.');
   }
 
+  static MapResult vmoMapRange(Handle vmo, int offset, int length, int flags) {
+    throw UnimplementedError(
+        'System.vmoMapRange() is not implemented on this platform.');
+  }
+
+  static MapResult vmoMapRegion(
+      Handle vmo, int offset, int length, int flags) {
+    throw UnimplementedError(
+        'System.vmoMapRegion() is not implemented on this platform.');
+  }
+
+  static int vmoUnmap(Handle region) {
+    throw UnimplementedError(
+        'System.vmoUnmap() is not implemented on this platform.');
+  }
+
+  static MapResult mapFile(String path, int offset, int length, bool exact) {
+    throw UnimplementedError(
+        'System.mapFile() is not implemented on this platform.');
+  }
+
+  // Handle operations.
+  static int handleCloseMany(List<Handle> handles) {
+    for (final Handle handle in handles) {
+      handle.close();
+    }
+    return 0;
+  }
+
   // Time operations.
   static int clockGet(int clockId) {
     throw UnimplementedError(
         'System.timeGet() is not implemented on this platform.');
   }
 
+  // Instrumentation. No natives run here, so the counters only change when
+  // they are written to directly, as tests do. The layout follows NativeStats
+  // in sdk_ext/native_stats.h: the names in the order of its Native enum, and
+  // per native its calls, errors, bytes and handles followed by the latency
+  // buckets.
+  static const List<String> _nativeStatsNames = <String>[
+    'Channel.write',
+    'Channel.writeV',
+    'Channel.read',
+    'Channel.call',
+    'Channel.readBatch',
+    'Socket.write',
+    'Socket.read',
+    'Vmo.write',
+    'Vmo.read',
+    'Handle.close',
+    'Handle.closeMany',
+    'Handle.duplicate',
+    'Handle.replace',
+    'Handle.wait',
+  ];
+  static const int _nativeStatsLatencyBuckets = 16;
+  static const int _nativeStatsFields = 4 + _nativeStatsLatencyBuckets;
+  static final Uint64List _nativeStats =
+      Uint64List(_nativeStatsNames.length * _nativeStatsFields);
+
+  static void setNativeStatsEnabled(bool enabled) {}
+
+  static Uint64List getNativeStats() => _nativeStats;
+
+  static List<String> getNativeStatsNames() => _nativeStatsNames;
+
+  // Tracing. Tracing is never on here.
+  static int setTraceFile(String path) {
+    throw UnimplementedError(
+        'System.setTraceFile() is not implemented on this platform.');
+  }
+
+  static const int TRACE_FIDL_ENCODE = 0;
+  static const int TRACE_FIDL_DECODE = 1;
+
+  static int traceBegin() => 0;
+
+  static void traceEnd(int event, int start, int ordinal) {}
+
+  // Allocation-free variants.
+  static int get lastNumBytes {
+    throw UnimplementedError(
+        'System.lastNumBytes is not implemented on this platform.');
+  }
+
+  static int get lastNumHandles {
+    throw UnimplementedError(
+        'System.lastNumHandles is not implemented on this platform.');
+  }
+
+  static int get lastSize {
+    throw UnimplementedError(
+        'System.lastSize is not implemented on this platform.');
+  }
+
+  static int socketWriteRaw(Handle socket, ByteData data, int options) {
+    throw UnimplementedError(
+        'System.socketWriteRaw() is not implemented on this platform.');
+  }
+
+  static int vmoGetSizeRaw(Handle vmo) {
+    throw UnimplementedError(
+        'System.vmoGetSizeRaw() is not implemented on this platform.');
+  }
+
+  static int channelReadInto(
+      Handle channel, ByteData target, List<Handle> handles) {
+    throw UnimplementedError(
+        'System.channelReadInto() is not implemented on this platform.');
+  }
+
+  static int get nativeAllocations {
+    throw UnimplementedError(
+        'System.nativeAllocations is not implemented on this platform.');
+  }
+
   // System operations.
   static int connectToService(String path, Handle channel) {
     throw UnimplementedError(
         'System.connectToService() is not implemented on this platform.');
   }
+
+  static int connectToServices(List<String> paths, List<Handle> channels) {
+    throw UnimplementedError(
+        'System.connectToServices() is not implemented on this platform.');
+  }
 }
@@ -0,0 +1,33 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of zircon_fakes;
+
+// ignore_for_file: public_member_api_docs
+
+typedef WaitPortCallback = void Function(Uint64List completions, int count);
+
+class WaitPort {
+  // Private constructor.
+  // ignore: unused_element
+  WaitPort._();
+
+  static const int allWaits = 1 << 32;
+
+  factory WaitPort(WaitPortCallback callback) {
+    throw UnimplementedError('WaitPort is not implemented on this platform.');
+  }
+
+  int wait(Handle handle, int signals, int key) {
+    throw UnimplementedError(
+        'WaitPort.wait() is not implemented on this platform.');
+  }
+
+  int cancel(Handle handle, int key) {
+    throw UnimplementedError(
+        'WaitPort.cancel() is not implemented on this platform.');
+  }
+
+  void close() {}
+}
@@ -10,3 +10,4 @@ import 'dart:typed_data';
 part 'handle.dart';
 part 'handle_waiter.dart';
 part 'system.dart';
+part 'wait_port.dart';
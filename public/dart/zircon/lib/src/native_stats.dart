@@ -0,0 +1,74 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of zircon;
+
+/// The counters of one `dart:zircon` native, as read by [NativeStats].
+class NativeCallStats {
+  /// The native, e.g. `Channel.write`.
+  final String name;
+
+  /// Number of calls.
+  final int calls;
+
+  /// Number of calls that returned a status other than [ZX.OK] or
+  /// [ZX.ERR_SHOULD_WAIT].
+  final int errors;
+
+  /// Bytes written or read.
+  final int bytes;
+
+  /// Handles sent, received or closed.
+  final int handles;
+
+  /// Calls by latency. Entry 0 counts calls under 1us, entry i > 0 calls that
+  /// took from 2^(i-1) up to 2^i microseconds. The last entry also counts all
+  /// longer calls.
+  final List<int> latencyHistogram;
+
+  NativeCallStats._(this.name, this.calls, this.errors, this.bytes,
+      this.handles, this.latencyHistogram);
+}
+
+/// Counts the calls that this isolate makes to the `dart:zircon` natives that
+/// move data or handles: channel, socket and VMO reads and writes, handle
+/// closes, duplicates and replaces, and waits. A wait's latency is the time
+/// from arming it to its completion.
+///
+/// Counting is off until [enable] is called. It is cheap enough to leave on.
+class NativeStats {
+  static const int _kCalls = 0;
+  static const int _kErrors = 1;
+  static const int _kBytes = 2;
+  static const int _kHandles = 3;
+  static const int _kLatencyBuckets = 4;
+
+  static List<String> _names;
+  static Uint64List _values;
+
+  NativeStats._();
+
+  /// Starts counting.
+  static void enable() => System.setNativeStatsEnabled(true);
+
+  /// Stops counting. The counters keep their values.
+  static void disable() => System.setNativeStatsEnabled(false);
+
+  /// Returns the current counters of every native.
+  static List<NativeCallStats> snapshot() {
+    _names ??= System.getNativeStatsNames();
+    _values ??= System.getNativeStats();
+    final int stride = _values.length ~/ _names.length;
+    return List<NativeCallStats>.generate(_names.length, (int i) {
+      final int base = i * stride;
+      return NativeCallStats._(
+          _names[i],
+          _values[base + _kCalls],
+          _values[base + _kErrors],
+          _values[base + _kBytes],
+          _values[base + _kHandles],
+          _values.sublist(base + _kLatencyBuckets, base + stride));
+    });
+  }
+}
@@ -47,6 +47,19 @@ class Socket extends _HandleWrapper<Socket> {
 
     return System.socketRead(handle, numBytes);
   }
+
+  /// Reads up to [numBytes] bytes into [target] starting at [targetOffset],
+  /// so that a streaming reader can reuse one buffer.
+  ///
+  /// Returns the status; the number of bytes read is then available from
+  /// [System.lastNumBytes].
+  int readInto(ByteData target, int targetOffset, int numBytes) {
+    if (handle == null) {
+      return ZX.ERR_INVALID_ARGS;
+    }
+
+    return System.socketReadInto(handle, target, targetOffset, numBytes);
+  }
 }
 
 /// Typed wrapper around a linked pair of socket objects and the
@@ -58,8 +58,10 @@ class SocketReader {
   }
 
   void _asyncWait() {
-    _waiter = _socket.handle
-        .asyncWait(Socket.READABLE | Socket.PEER_CLOSED, _handleWaitComplete);
+    // The waiter stays armed across reads until it is cancelled or only
+    // peer-closed is left to report.
+    _waiter = _socket.handle.asyncWaitPersistent(
+        Socket.READABLE | Socket.PEER_CLOSED, _handleWaitComplete);
   }
 
   void _errorSoon(SocketReaderError error) {
@@ -94,9 +96,6 @@ class SocketReader {
         if (onReadable != null) {
           onReadable();
         }
-        if (isBound) {
-          _asyncWait();
-        }
       } else if ((pending & Socket.PEER_CLOSED) != 0) {
         close();
         _errorSoon(null);
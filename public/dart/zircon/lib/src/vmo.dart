@@ -10,6 +10,28 @@ part of zircon;
 class Vmo extends _HandleWrapper<Vmo> {
   Vmo(Handle handle) : super(handle);
 
+  /// Maps [length] bytes of the file at [path] in the current Isolate's
+  /// namespace, starting at [offset], and returns them without copying. When
+  /// [length] is null the rest of the file is mapped.
+  ///
+  /// By default a copy-on-write clone of the file's VMO is mapped, which is
+  /// isolated from later changes to the file. If [exact] is true the file's
+  /// own VMO is mapped instead.
+  ///
+  /// The returned [Uint8List] is read-only.
+  static Uint8List mapFile(String path,
+      {int offset = 0, int length, bool exact = false}) {
+    if (offset < 0 || (length != null && length <= 0)) {
+      const int status = ZX.ERR_INVALID_ARGS;
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+    MapResult r = System.mapFile(path, offset, length ?? 0, exact);
+    if (r.status != ZX.OK) {
+      throw ZxStatusException(r.status, getStringForStatus(r.status));
+    }
+    return UnmodifiableUint8ListView(r.data);
+  }
+
   GetSizeResult getSize() {
     if (handle == null) {
       return const GetSizeResult(ZX.ERR_INVALID_ARGS);
@@ -47,6 +69,18 @@ class Vmo extends _HandleWrapper<Vmo> {
     return System.vmoRead(handle, vmoOffset, numBytes);
   }
 
+  /// Reads [numBytes] bytes at [vmoOffset] into [target] starting at
+  /// [targetOffset], without allocating a new buffer.
+  int readInto(ByteData target, int targetOffset, int numBytes,
+      [int vmoOffset = 0]) {
+    if (handle == null) {
+      return ZX.ERR_INVALID_ARGS;
+    }
+
+    return System.vmoReadInto(
+        handle, vmoOffset, target, targetOffset, numBytes);
+  }
+
   /// Maps the Vmo into the process's root vmar, and returns it as a typed data
   /// array.
   ///
@@ -63,6 +97,92 @@ class Vmo extends _HandleWrapper<Vmo> {
     }
     return UnmodifiableUint8ListView(r.data);
   }
+
+  /// Maps [length] bytes of the Vmo starting at [offset] into the process's
+  /// root vmar, and returns them as a typed data array. A [length] of zero
+  /// maps the rest of the Vmo.
+  ///
+  /// If [writable] is true, stores into the returned [Uint8List] go straight
+  /// to the Vmo without a syscall. Otherwise the list is read-only.
+  Uint8List mapRange({int offset = 0, int length = 0, bool writable = false}) {
+    if (handle == null) {
+      const int status = ZX.ERR_INVALID_ARGS;
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+    MapResult r = System.vmoMapRange(
+        handle, offset, length, writable ? ZX.VM_PERM_WRITE : 0);
+    if (r.status != ZX.OK) {
+      throw ZxStatusException(r.status, getStringForStatus(r.status));
+    }
+    return writable ? r.data : UnmodifiableUint8ListView(r.data);
+  }
+
+  /// Maps a range of the Vmo like [mapRange], but returns a [VmoMapping] that
+  /// can be unmapped as soon as the caller is done with it instead of when
+  /// the garbage collector finds the mapped list.
+  ///
+  /// If [prefault] is true, the pages are committed and mapped up front.
+  VmoMapping mapRegion(
+      {int offset = 0,
+      int length = 0,
+      bool writable = false,
+      bool prefault = false}) {
+    if (handle == null) {
+      const int status = ZX.ERR_INVALID_ARGS;
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+    int flags = 0;
+    if (writable) {
+      flags |= ZX.VM_PERM_WRITE;
+    }
+    if (prefault) {
+      flags |= ZX.VM_MAP_RANGE;
+    }
+    MapResult r = System.vmoMapRegion(handle, offset, length, flags);
+    if (r.status != ZX.OK) {
+      throw ZxStatusException(r.status, getStringForStatus(r.status));
+    }
+    return VmoMapping._(
+        writable ? r.data : UnmodifiableUint8ListView(r.data), r.region);
+  }
+}
+
+/// A range of a [Vmo] mapped into the process by [Vmo.mapRegion].
+class VmoMapping {
+  VmoMapping._(this._data, this._region);
+
+  final Uint8List _data;
+  Handle _region;
+
+  /// The mapped bytes.
+  ///
+  /// Throws a [StateError] once the mapping has been unmapped. A list read
+  /// before [unmap] and kept after it no longer reflects the Vmo: it reads
+  /// as zeros, and writing to it faults.
+  Uint8List get data {
+    if (_region == null) {
+      throw StateError('The VmoMapping has been unmapped.');
+    }
+    return _data;
+  }
+
+  bool get isMapped => _region != null;
+
+  /// Unmaps [data], releasing the Vmo's pages from this mapping immediately.
+  ///
+  /// The address range stays reserved, backed by read-only zero pages, until
+  /// the garbage collector finds every list that views it.
+  void unmap() {
+    if (_region == null) {
+      return;
+    }
+    final int status = System.vmoUnmap(_region);
+    _region.close();
+    _region = null;
+    if (status != ZX.OK) {
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+  }
 }
 
 /// Typed wrapper around a Zircon vmo object, which also tracks its size.
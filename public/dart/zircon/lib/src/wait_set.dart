@@ -0,0 +1,125 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of zircon;
+
+/// A pending wait started with [WaitSet.asyncWait].
+class WaitSetWaiter {
+  final WaitSet _set;
+  final Handle _handle;
+  final int _key;
+  final AsyncWaitCallback _callback;
+  final Zone _zone = Zone.current;
+
+  WaitSetWaiter._(this._set, this._handle, this._key, this._callback);
+
+  /// Whether the wait has neither completed nor been cancelled.
+  bool get isPending => identical(_set._waiters[_key], this);
+
+  // Errors are reported to the zone of the caller of asyncWait, and do not
+  // stop the rest of the batch from being delivered.
+  void _complete(int status, int observed) =>
+      _zone.runBinaryGuarded(_callback, status, observed);
+
+  /// Cancels the wait. The callback will not be called.
+  void cancel() {
+    if (isPending) {
+      _set._waiters.remove(_key);
+      _set._port.cancel(_handle, _key);
+    }
+  }
+}
+
+/// Multiplexes one-shot handle waits over a single [WaitPort].
+///
+/// [Handle.asyncWait] registers every wait with the message loop separately
+/// and runs each callback in its own microtask. A [WaitSet] registers its
+/// waits on one port instead and runs all the callbacks of the waits that
+/// completed together in one microtask, which is cheaper when many handles
+/// become ready at once.
+///
+/// Closing a handle drops its wait without calling the callback, as does
+/// closing the set or letting it be collected.
+class WaitSet {
+  // Keys are 32 bits wide; see WaitPort.wait.
+  static const int _maxKey = 0xffffffff;
+  static const int _minSweepLength = 16;
+
+  WaitPort _port;
+  final Map<int, WaitSetWaiter> _waiters = <int, WaitSetWaiter>{};
+  int _nextKey = 0;
+  // The number of waits at which the next asyncWait sweeps out the waits on
+  // closed handles.
+  int _sweepLength = _minSweepLength;
+
+  WaitSet() {
+    _port = WaitPort(_handleCompletions);
+  }
+
+  /// The number of pending waits.
+  int get length {
+    _sweep();
+    return _waiters.length;
+  }
+
+  /// Waits for any of [signals] on [handle] and calls [callback] once with
+  /// the wait status and the observed signals.
+  ///
+  /// [callback] runs in the zone this is called from, and an error it throws
+  /// is reported to that zone. The other callbacks of the batch still run.
+  WaitSetWaiter asyncWait(
+      Handle handle, int signals, AsyncWaitCallback callback) {
+    if (_port == null) {
+      throw ZirconApiError('WaitSet is closed.');
+    }
+    if (_waiters.length >= _sweepLength) {
+      // Doubling the threshold keeps the cost of sweeping constant per wait.
+      _sweep();
+      _sweepLength = max(_minSweepLength, 2 * _waiters.length);
+    }
+    int key = _nextKey;
+    while (_waiters.containsKey(key)) {
+      key = (key + 1) & _maxKey;
+    }
+    _nextKey = (key + 1) & _maxKey;
+    final int status = _port.wait(handle, signals, key);
+    if (status != ZX.OK) {
+      throw ZxStatusException(status, getStringForStatus(status));
+    }
+    return _waiters[key] = WaitSetWaiter._(this, handle, key, callback);
+  }
+
+  /// Drops all pending waits without calling their callbacks.
+  void close() {
+    _port?.close();
+    _port = null;
+    _waiters.clear();
+  }
+
+  // The kernel drops the wait on a handle when the handle is closed, so it
+  // never completes and its entry has to be removed here.
+  void _sweep() {
+    _waiters.removeWhere((int key, WaitSetWaiter waiter) =>
+        !waiter._handle.isValid);
+  }
+
+  void _handleCompletions(Uint64List completions, int count) {
+    for (int i = 0; i < count; i++) {
+      final int key = completions[3 * i];
+      final int status = completions[3 * i + 1];
+      final int observed = completions[3 * i + 2];
+      if (key == WaitPort.allWaits) {
+        // The port failed, so the waits still pending will never complete.
+        final List<WaitSetWaiter> waiters = _waiters.values.toList();
+        _waiters.clear();
+        for (WaitSetWaiter waiter in waiters) {
+          waiter._complete(status, 0);
+        }
+        continue;
+      }
+      // The wait may have been cancelled after it completed.
+      _waiters.remove(key)?._complete(status, observed);
+    }
+  }
+}
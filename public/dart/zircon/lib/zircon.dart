@@ -9,6 +9,7 @@
 library zircon;
 
 import 'dart:async';
+import 'dart:math' show max;
 import 'dart:typed_data';
 
 import 'src/fakes/zircon_fakes.dart' if (dart.library.zircon) 'dart:zircon';
@@ -21,6 +22,8 @@ part 'src/constants.dart';
 part 'src/errors.dart';
 part 'src/eventpair.dart';
 part 'src/handle_wrapper.dart';
+part 'src/native_stats.dart';
 part 'src/socket.dart';
 part 'src/socket_reader.dart';
 part 'src/vmo.dart';
+part 'src/wait_set.dart';
@@ -21,6 +21,19 @@ int main(int argc, const char** argv) {
   //     "dart_inspect.basic_benchmarks",
   //     "/pkgfs/packages/dart_inspect_benchmarks/0/data/basic_benchmarks.tspec");
 
+  {
+    constexpr const char* kLabel = "fuchsia.dart_zircon";
+    std::string out_file =
+        benchmarks_runner.MakePerfResultsOutputFilename(kLabel);
+    benchmarks_runner.AddCustomBenchmark(
+        kLabel,
+        {"/bin/run",
+         "fuchsia-pkg://fuchsia.com/dart_zircon_benchmarks#meta/"
+         "dart_zircon_benchmarks.cmx",
+         "--out_file", out_file, "--benchmark_label", kLabel},
+        out_file);
+  }
+
   // TODO(PT-118): Input latency tests are only currently supported on NUC.
 #if !defined(__aarch64__)
   constexpr const char* kLabel = "fuchsia.input_latency.button_flutter";
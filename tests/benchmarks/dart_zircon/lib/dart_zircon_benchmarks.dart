@@ -0,0 +1,46 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'package:args/args.dart';
+import 'package:fuchsia/fuchsia.dart' as fuchsia;
+
+import 'src/async_wait.dart';
+import 'src/channel.dart';
+import 'src/handle.dart';
+import 'src/harness.dart';
+import 'src/socket.dart';
+import 'src/vmo.dart';
+
+Future<void> main(List<String> args) async {
+  var parser = ArgParser()
+    ..addOption('out_file', valueHelp: 'path')
+    ..addOption('benchmark_label',
+        defaultsTo: 'fuchsia.dart_zircon', valueHelp: 'label')
+    ..addOption('samples', defaultsTo: '10', valueHelp: 'samples');
+
+  ArgResults parsedArgs;
+  int samples;
+  try {
+    parsedArgs = parser.parse(args);
+    samples = int.parse(parsedArgs['samples']);
+  } on FormatException {
+    print('dart_zircon_benchmarks got bad args. Please check usage.');
+    print('  args = "$args"');
+    print(parser.usage);
+    fuchsia.exit(1);
+  }
+
+  final suite = BenchmarkSuite(parsedArgs['benchmark_label'], samples: samples);
+  runChannelBenchmarks(suite);
+  runSocketBenchmarks(suite);
+  runVmoBenchmarks(suite);
+  runHandleBenchmarks(suite);
+  await runAsyncWaitBenchmarks(suite);
+
+  final String outFile = parsedArgs['out_file'];
+  if (outFile != null) {
+    suite.write(outFile);
+  }
+  fuchsia.exit(0);
+}
@@ -0,0 +1,53 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:zircon/zircon.dart';
+
+import 'harness.dart';
+
+Future<void> runAsyncWaitBenchmarks(BenchmarkSuite suite) async {
+  final ByteData data = ByteData(16);
+
+  // From making a channel readable to running the callback of a wait for
+  // it, with a new wait every time.
+  {
+    final ChannelPair pair = ChannelPair();
+    await suite.asyncLatency('AsyncWait/Dispatch', () {
+      final Completer<void> completer = Completer<void>();
+      pair.second.handle.asyncWait(Channel.READABLE, (int status, int pending) {
+        pair.second.read();
+        completer.complete();
+      });
+      pair.first.write(data);
+      return completer.future;
+    }, teardown: () {
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+
+  // The same with one persistent wait, which is rearmed without a new
+  // HandleWaiter.
+  {
+    final ChannelPair pair = ChannelPair();
+    Completer<void> completer;
+    final HandleWaiter waiter = pair.second.handle
+        .asyncWaitPersistent(Channel.READABLE, (int status, int pending) {
+      pair.second.read();
+      completer.complete();
+    });
+    await suite.asyncLatency('AsyncWait/DispatchPersistent', () {
+      completer = Completer<void>();
+      pair.first.write(data);
+      return completer.future;
+    }, teardown: () {
+      waiter.cancel();
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+}
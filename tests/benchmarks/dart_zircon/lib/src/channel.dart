@@ -0,0 +1,69 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:zircon/zircon.dart';
+
+import 'harness.dart';
+
+const List<int> _messageSizes = [16, 1024, 16384, 65536];
+const List<int> _handleCounts = [1, 4, 16, 64];
+
+// Messages written before they are read back, for throughput.
+const int _batch = 8;
+
+void runChannelBenchmarks(BenchmarkSuite suite) {
+  // A message to the other end and back.
+  for (final int size in _messageSizes) {
+    final ChannelPair pair = ChannelPair();
+    final ByteData data = ByteData(size);
+    suite.latency('Channel/PingPong/${sizeLabel(size)}', () {
+      pair.first.write(data);
+      pair.second.write(pair.second.read().bytes);
+      pair.first.read();
+    }, teardown: () {
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+
+  // The same handles go back and forth, so this measures moving handles
+  // through the kernel and wrapping them on the way out, not creating them.
+  for (final int count in _handleCounts) {
+    final ChannelPair pair = ChannelPair();
+    final ByteData data = ByteData(16);
+    List<Handle> handles = List<Handle>.generate(count, (_) {
+      final HandlePairResult result = System.eventpairCreate();
+      result.second.close();
+      return result.first;
+    });
+    suite.latency('Channel/PingPong/${count}Handles', () {
+      pair.first.write(data, handles);
+      pair.second.write(data, pair.second.read().handles);
+      handles = pair.first.read().handles;
+    }, teardown: () {
+      System.handleCloseMany(handles);
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+
+  for (final int size in _messageSizes) {
+    final ChannelPair pair = ChannelPair();
+    final ByteData data = ByteData(size);
+    suite.throughput('Channel/Throughput/${sizeLabel(size)}', size * _batch,
+        () {
+      for (int i = 0; i < _batch; i++) {
+        pair.first.write(data);
+      }
+      for (int i = 0; i < _batch; i++) {
+        pair.second.read();
+      }
+    }, teardown: () {
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+}
@@ -0,0 +1,43 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'package:zircon/zircon.dart';
+
+import 'harness.dart';
+
+const int _closeManyCount = 16;
+
+void runHandleBenchmarks(BenchmarkSuite suite) {
+  suite.latency('Handle/CreateClose/Channel', () {
+    final HandlePairResult result = System.channelCreate();
+    result.first.close();
+    result.second.close();
+  });
+
+  suite.latency('Handle/CreateClose/EventPair', () {
+    final HandlePairResult result = System.eventpairCreate();
+    result.first.close();
+    result.second.close();
+  });
+
+  suite.latency('Handle/CreateClose/Socket', () {
+    final HandlePairResult result = System.socketCreate();
+    result.first.close();
+    result.second.close();
+  });
+
+  suite.latency('Handle/CreateClose/Vmo', () {
+    System.vmoCreate(4096).handle.close();
+  });
+
+  final Handle event = System.eventpairCreate().first;
+  suite.latency('Handle/DuplicateClose', () {
+    event.duplicate(ZX.RIGHT_SAME_RIGHTS).close();
+  });
+
+  suite.latency('Handle/CloseMany/$_closeManyCount', () {
+    System.handleCloseMany(List<Handle>.generate(
+        _closeManyCount, (_) => event.duplicate(ZX.RIGHT_SAME_RIGHTS)));
+  }, teardown: event.close);
+}
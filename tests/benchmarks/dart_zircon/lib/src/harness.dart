@@ -0,0 +1,118 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:convert';
+import 'dart:io';
+
+/// Runs benchmarks and collects their results in the perf results format
+/// that the CI benchmark runner uploads.
+class BenchmarkSuite {
+  /// The test suite the results are reported under.
+  final String testSuite;
+
+  /// The number of values recorded for every benchmark.
+  final int samples;
+
+  /// The minimum time each sample runs for.
+  final Duration sampleDuration;
+
+  final List<Map<String, dynamic>> _results = [];
+
+  BenchmarkSuite(this.testSuite,
+      {this.samples = 10,
+      this.sampleDuration = const Duration(milliseconds: 100)});
+
+  /// Records the mean time per call of [run], in nanoseconds.
+  void latency(String label, void Function() run,
+      {void Function() teardown}) {
+    _record(label, 'nanoseconds',
+        _sample(run, (double nanos, int calls) => nanos / calls), teardown);
+  }
+
+  /// Records the bandwidth of [run], which moves [bytes] bytes per call, in
+  /// bytes per second.
+  void throughput(String label, int bytes, void Function() run,
+      {void Function() teardown}) {
+    _record(
+        label,
+        'bytes/second',
+        _sample(run, (double nanos, int calls) => bytes * calls * 1e9 / nanos),
+        teardown);
+  }
+
+  /// Records the mean time until the future returned by [run] completes,
+  /// in nanoseconds.
+  Future<void> asyncLatency(String label, Future<void> Function() run,
+      {void Function() teardown}) async {
+    final List<double> values = [];
+    await _measureAsync(run);
+    for (int i = 0; i < samples; i++) {
+      values.add(await _measureAsync(run));
+    }
+    _record(label, 'nanoseconds', values, teardown);
+  }
+
+  /// Writes the results recorded so far to [path].
+  void write(String path) {
+    File(path).writeAsStringSync(json.encode(_results));
+  }
+
+  List<double> _sample(void Function() run,
+      double Function(double nanos, int calls) value) {
+    // Warm up first and discard the result.
+    _measure(run, value);
+    return List<double>.generate(samples, (_) => _measure(run, value));
+  }
+
+  double _measure(void Function() run,
+      double Function(double nanos, int calls) value) {
+    final int minimumMicros = sampleDuration.inMicroseconds;
+    final Stopwatch watch = Stopwatch()..start();
+    int calls = 0;
+    while (watch.elapsedMicroseconds < minimumMicros) {
+      run();
+      calls++;
+    }
+    return value(_nanos(watch), calls);
+  }
+
+  Future<double> _measureAsync(Future<void> Function() run) async {
+    final int minimumMicros = sampleDuration.inMicroseconds;
+    final Stopwatch watch = Stopwatch()..start();
+    int calls = 0;
+    while (watch.elapsedMicroseconds < minimumMicros) {
+      await run();
+      calls++;
+    }
+    return _nanos(watch) / calls;
+  }
+
+  double _nanos(Stopwatch watch) => watch.elapsedTicks * 1e9 / watch.frequency;
+
+  void _record(String label, String unit, List<double> values,
+      void Function() teardown) {
+    if (teardown != null) {
+      teardown();
+    }
+    _results.add({
+      'label': label,
+      'test_suite': testSuite,
+      'unit': unit,
+      'values': values,
+    });
+    final double mean = values.reduce((a, b) => a + b) / values.length;
+    print('$label: ${mean.toStringAsFixed(1)} $unit');
+  }
+}
+
+/// A short name for a size in bytes, like '16B' or '64KiB'.
+String sizeLabel(int bytes) {
+  if (bytes >= 1 << 20 && bytes % (1 << 20) == 0) {
+    return '${bytes >> 20}MiB';
+  }
+  if (bytes >= 1 << 10 && bytes % (1 << 10) == 0) {
+    return '${bytes >> 10}KiB';
+  }
+  return '${bytes}B';
+}
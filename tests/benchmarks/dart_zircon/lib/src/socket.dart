@@ -0,0 +1,40 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:zircon/zircon.dart';
+
+import 'harness.dart';
+
+const List<int> _streamSizes = [1024, 16384, 65536];
+const List<int> _datagramSizes = [64, 1024, 8192];
+
+void runSocketBenchmarks(BenchmarkSuite suite) {
+  for (final int size in _streamSizes) {
+    final SocketPair pair = SocketPair(Socket.STREAM);
+    final ByteData data = ByteData(size);
+    final ByteData target = ByteData(size);
+    suite.throughput('Socket/Stream/${sizeLabel(size)}', size, () {
+      pair.first.write(data);
+      pair.second.readInto(target, 0, size);
+    }, teardown: () {
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+
+  for (final int size in _datagramSizes) {
+    final SocketPair pair = SocketPair(Socket.DATAGRAM);
+    final ByteData data = ByteData(size);
+    final ByteData target = ByteData(size);
+    suite.throughput('Socket/Datagram/${sizeLabel(size)}', size, () {
+      pair.first.write(data);
+      pair.second.readInto(target, 0, size);
+    }, teardown: () {
+      pair.first.close();
+      pair.second.close();
+    });
+  }
+}
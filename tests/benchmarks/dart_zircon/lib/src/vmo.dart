@@ -0,0 +1,47 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:zircon/zircon.dart';
+
+import 'harness.dart';
+
+const List<int> _sizes = [4096, 65536, 1 << 20];
+const int _pageSize = 4096;
+
+// Keeps the reads of mapped pages from being optimized away.
+int _sink = 0;
+
+void runVmoBenchmarks(BenchmarkSuite suite) {
+  for (final int size in _sizes) {
+    final Vmo vmo = Vmo(System.vmoCreate(size).handle);
+    final ByteData data = ByteData(size);
+    suite.throughput('Vmo/Write/${sizeLabel(size)}', size, () {
+      vmo.write(data);
+    }, teardown: vmo.close);
+  }
+
+  for (final int size in _sizes) {
+    final Vmo vmo = Vmo(System.vmoCreate(size).handle);
+    final ByteData target = ByteData(size);
+    suite.throughput('Vmo/Read/${sizeLabel(size)}', size, () {
+      vmo.readInto(target, 0, size);
+    }, teardown: vmo.close);
+  }
+
+  // Mapping, touching every page and unmapping, which is what reading a
+  // mapped VMO once costs.
+  for (final int size in _sizes) {
+    final Vmo vmo = Vmo(System.vmoCreate(size).handle)..write(ByteData(size));
+    suite.throughput('Vmo/Map/${sizeLabel(size)}', size, () {
+      final VmoMapping mapping = vmo.mapRegion(length: size);
+      final Uint8List data = mapping.data;
+      for (int offset = 0; offset < size; offset += _pageSize) {
+        _sink += data[offset];
+      }
+      mapping.unmap();
+    }, teardown: vmo.close);
+  }
+}
@@ -9,11 +9,12 @@ typedef _DefinitionBlock = void Function(
 class _Definition {
   final String name;
   final _DefinitionBlock block;
+  final int Function() allocations;
 
   void Function() _run;
   void Function() _teardown;
 
-  _Definition(this.name, this.block);
+  _Definition(this.name, this.block, this.allocations);
 
   void execute() {
     this.block((void Function() run) => _run = run,
@@ -28,11 +29,19 @@ class _Definition {
     // Run the benchmark for at least 2000ms.
     double result = _measure(2000);
 
+    double allocationsPerRun;
+    if (allocations != null) {
+      allocationsPerRun = _countAllocations(1000);
+    }
+
     if (_teardown != null) {
       _teardown();
     }
 
     print('$name: ${result}us');
+    if (allocationsPerRun != null) {
+      print('$name: $allocationsPerRun allocations');
+    }
   }
 
   // Measures the score for this benchmark by executing it repeately until
@@ -49,12 +58,26 @@ class _Definition {
     }
     return elapsed / iter;
   }
+
+  // Counts the allocations reported by [allocations] over [runs] executions
+  // of the benchmark, per execution.
+  double _countAllocations(int runs) {
+    final int start = allocations();
+    for (int i = 0; i < runs; i++) {
+      _run();
+    }
+    return (allocations() - start) / runs;
+  }
 }
 
 final List<_Definition> _definitions = [];
 
-void benchmark(final String name, final _DefinitionBlock block) {
-  _definitions.add(_Definition(name, block));
+/// Defines a benchmark called [name]. If [allocations] is given, it is a
+/// running count of allocations, and the allocations per run are reported
+/// along with the time.
+void benchmark(final String name, final _DefinitionBlock block,
+    {int Function() allocations}) {
+  _definitions.add(_Definition(name, block, allocations));
 }
 
 void runBenchmarks() {
@@ -6,11 +6,15 @@ import 'package:fuchsia/fuchsia.dart';
 
 import './benchmark.dart';
 import './string.dart';
+import './system.dart';
 
 void main(List<String> args) {
   // Include string benchmarks.
   addStringBenchmarks();
 
+  // Include dart:zircon native call benchmarks.
+  addSystemBenchmarks();
+
   // Run all benchmarks.
   runBenchmarks();
 
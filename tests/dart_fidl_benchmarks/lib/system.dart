@@ -0,0 +1,149 @@
+// Copyright 2020 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+import 'dart:typed_data';
+
+import 'package:zircon/zircon.dart';
+
+import './benchmark.dart';
+
+void addSystemBenchmarks() {
+  // The fixed per-call overhead of a leaf native.
+  benchmark('native call overhead, leaf (System.clockGet)', (run, teardown) {
+    run(() => System.clockGet(0));
+  });
+
+  // The result-object natives against their allocation-free variants. Each
+  // pair reports the Dart objects its natives allocate per run, as counted
+  // by System.nativeAllocations. Both sides of a pair drain or fill with the
+  // same allocation-free call, so only the native being compared differs.
+  benchmark('socket write with result object', (run, teardown) {
+    final pair = SocketPair();
+    final data = ByteData(16);
+    final target = ByteData(16);
+    run(() {
+      System.socketWrite(pair.first.handle, data, 0);
+      System.socketReadInto(pair.second.handle, target, 0, 16);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  benchmark('socket write raw', (run, teardown) {
+    final pair = SocketPair();
+    final data = ByteData(16);
+    final target = ByteData(16);
+    run(() {
+      System.socketWriteRaw(pair.first.handle, data, 0);
+      System.socketReadInto(pair.second.handle, target, 0, 16);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  benchmark('socket read with result object', (run, teardown) {
+    final pair = SocketPair();
+    final data = ByteData(16);
+    run(() {
+      System.socketWriteRaw(pair.first.handle, data, 0);
+      System.socketRead(pair.second.handle, 16);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  benchmark('socket read into', (run, teardown) {
+    final pair = SocketPair();
+    final data = ByteData(16);
+    final target = ByteData(16);
+    run(() {
+      System.socketWriteRaw(pair.first.handle, data, 0);
+      System.socketReadInto(pair.second.handle, target, 0, 16);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  benchmark('vmo read with result object', (run, teardown) {
+    final vmo = System.vmoCreate(4096).handle;
+    run(() => System.vmoRead(vmo, 0, 16));
+    teardown(vmo.close);
+  }, allocations: _nativeAllocations);
+
+  benchmark('vmo read into', (run, teardown) {
+    final vmo = System.vmoCreate(4096).handle;
+    final target = ByteData(16);
+    run(() => System.vmoReadInto(vmo, 0, target, 0, 16));
+    teardown(vmo.close);
+  }, allocations: _nativeAllocations);
+
+  benchmark('vmo get size with result object', (run, teardown) {
+    final vmo = System.vmoCreate(4096).handle;
+    run(() => System.vmoGetSize(vmo).size);
+    teardown(vmo.close);
+  }, allocations: _nativeAllocations);
+
+  benchmark('vmo get size raw', (run, teardown) {
+    final vmo = System.vmoCreate(4096).handle;
+    run(() => System.vmoGetSizeRaw(vmo) == ZX.OK ? System.lastSize : 0);
+    teardown(vmo.close);
+  }, allocations: _nativeAllocations);
+
+  benchmark('channel read with result object', (run, teardown) {
+    final pair = ChannelPair();
+    final data = ByteData(16);
+    run(() {
+      System.channelWrite(pair.first.handle, data, const <Handle>[]);
+      System.channelRead(pair.second.handle);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  benchmark('channel read into', (run, teardown) {
+    final pair = ChannelPair();
+    final data = ByteData(16);
+    final target = ByteData(Channel.MAX_MSG_BYTES);
+    run(() {
+      System.channelWrite(pair.first.handle, data, const <Handle>[]);
+      System.channelReadInto(pair.second.handle, target, null);
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+    });
+  }, allocations: _nativeAllocations);
+
+  // Every handle in a received message becomes a new Handle object, so this
+  // measures the per-handle construction cost of decoding.
+  benchmark('channel round trip with 16 handles', (run, teardown) {
+    final pair = ChannelPair();
+    final event = EventPairPair();
+    final data = ByteData(16);
+    run(() {
+      final handles = List<Handle>.generate(
+          16, (_) => event.first.handle.duplicate(ZX.RIGHT_SAME_RIGHTS));
+      pair.first.write(data, handles);
+      pair.second.read().handles.forEach((handle) => handle.close());
+    });
+    teardown(() {
+      pair.first.close();
+      pair.second.close();
+      event.first.close();
+      event.second.close();
+    });
+  });
+}
+
+int _nativeAllocations() => System.nativeAllocations;